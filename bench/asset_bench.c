@@ -0,0 +1,186 @@
+#include "bench_common.h"
+#include "assets.h"
+
+// the asset cache: opening a baked model against making it, and box/mesh queries on welded hulls against the raw vertices.
+// the game's miss path parses a glb, which costs more than GenGroundTile, so the build numbers here are a floor
+// run from the repo root: bin/Release/asset_bench
+
+#define BENCH_REPEATS 5
+#define BENCH_QUERIES 20000
+#define GROUND_TILES 4          // per side, each tile its own mesh like the map's
+#define GROUND_QUADS 32         // per tile side
+#define GROUND_SIZE 16.0f
+#define BENCH_ASSET "asset_bench.asset"
+#define BENCH_HASH 1
+
+// unindexed like raylib's glb import, every corner once per triangle
+Model BuildGround(void) {
+    Model ground = { 0 };
+    ground.transform = MatrixIdentity();
+    ground.meshCount = GROUND_TILES * GROUND_TILES;
+    ground.meshes = RL_CALLOC(ground.meshCount, sizeof(Mesh));
+
+    float tileSize = GROUND_SIZE / GROUND_TILES;
+    for(int ty = 0; ty < GROUND_TILES; ty ++) {
+        for(int tx = 0; tx < GROUND_TILES; tx ++) {
+            Mesh * mesh = &ground.meshes[ty * GROUND_TILES + tx];
+            *mesh = GenGroundTile(-GROUND_SIZE / 2 + tx * tileSize, -GROUND_SIZE / 2 + ty * tileSize, tileSize, GROUND_QUADS, false);
+            UploadMesh(mesh, false);
+        }
+    }
+    return ground;
+}
+
+float MaxDot(const Vector3 * verts, int count, Vector3 dir) {
+    float best = -FLT_MAX;
+    for(int i = 0; i < count; i ++) {
+        float d = Vector3DotProduct(verts[i], dir);
+        if(d > best)
+            best = d;
+    }
+    return best;
+}
+
+// same boxes, and the hull is the same shape to every support query
+bool CheckAsset(Model ground, const AssetModel * asset) {
+    if(asset->model.meshCount != ground.meshCount)
+        return false;
+
+    for(int m = 0; m < ground.meshCount; m ++) {
+        Mesh mesh = ground.meshes[m];
+        BoundingBox box = GetMeshBoundingBox(mesh);
+        if(memcmp(&box, &asset->boxes[m], sizeof(BoundingBox)) != 0)
+            return false;
+        if(memcmp(mesh.vertices, asset->model.meshes[m].vertices, sizeof(float) * 3 * mesh.vertexCount) != 0)
+            return false;
+
+        const Vector3 * hull = SNAPSHOT_PTR(asset->file.data, asset->hulls[m].verts);
+        for(int d = 0; d < 64; d ++) {
+            Vector3 dir = Vector3Normalize((Vector3){ BenchRandom(-1, 1), BenchRandom(-1, 1), BenchRandom(-1, 1) });
+            if(MaxDot(hull, asset->hulls[m].count, dir) != MaxDot((Vector3 *)mesh.vertices, mesh.vertexCount, dir))
+                return false;
+        }
+    }
+    return true;
+}
+
+double TimeBuild(void) {
+    double start = BenchNanoseconds();
+    Model ground = BuildGround();
+    GetModelMeshCollidersArena(FrameArena(), ground, MatrixIdentity());
+    double time = BenchNanoseconds() - start;
+
+    UnloadModel(ground);
+    FrameArenaReset();
+    return time;
+}
+
+double TimeOpen(void) {
+    AssetModel asset;
+    double start = BenchNanoseconds();
+    bool ok = OpenAssetModel(BENCH_ASSET, BENCH_HASH, &asset);
+    if(ok)
+        GetAssetMeshCollidersArena(FrameArena(), &asset, MatrixIdentity());
+    double time = BenchNanoseconds() - start;
+
+    if(ok)
+        UnloadAssetModel(&asset);
+    FrameArenaReset();
+    return ok ? time : -1.0;
+}
+
+// every query box against every collider it overlaps, like GatherActorContacts does
+double TimeQueries(const MeshCollider * colliders, int count, const BoundingBox * boxes, int * hits, float * depth) {
+    *hits = 0;
+    *depth = 0.0f;
+    double start = BenchNanoseconds();
+    for(int q = 0; q < BENCH_QUERIES; q ++) {
+        for(int c = 0; c < count; c ++) {
+            if(!BoundingBoxIntersects(boxes[q], colliders[c].worldBox))
+                continue;
+            Collision hit = BoxMeshCollision(boxes[q], colliders[c]);
+            if(hit.hit) {
+                (*hits) ++;
+                *depth += hit.depth;
+            }
+        }
+    }
+    return BenchNanoseconds() - start;
+}
+
+int main(void) {
+    ecs_os_set_api_defaults();
+
+    // UploadMesh needs a context
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(64, 64, "asset_bench");
+
+    Model ground = BuildGround();
+    AssetModel asset;
+    if(!BakeAssetModel(BENCH_ASSET, ground, BENCH_HASH) || !OpenAssetModel(BENCH_ASSET, BENCH_HASH, &asset)) {
+        printf("couldn't bake %s\n", BENCH_ASSET);
+        return 1;
+    }
+    AssetModel stale;
+    if(!CheckAsset(ground, &asset) || OpenAssetModel(BENCH_ASSET, BENCH_HASH + 1, &stale)) {
+        printf("the baked asset doesn't match its source\n");
+        return 1;
+    }
+
+    double bestBuild = TimeBuild();
+    double bestOpen = TimeOpen();
+    for(int i = 1; i < BENCH_REPEATS; i ++) {
+        double t = TimeBuild();
+        if(t < bestBuild)
+            bestBuild = t;
+        t = TimeOpen();
+        if(t < bestOpen)
+            bestOpen = t;
+    }
+
+    // actor sized boxes sitting in the ground
+    BoundingBox * boxes = malloc(sizeof(BoundingBox) * BENCH_QUERIES);
+    for(int i = 0; i < BENCH_QUERIES; i ++) {
+        float x = BenchRandom(-7.5f, 7.5f);
+        float y = BenchRandom(-7.5f, 7.5f);
+        float z = GroundHeight(x, y) - 0.05f;
+        boxes[i] = (BoundingBox){ { x - 0.25f, y - 0.25f, z }, { x + 0.25f, y + 0.25f, z + 0.875f } };
+    }
+
+    MeshCollider * raw = GetModelMeshCollidersArena(FrameArena(), ground, MatrixIdentity());
+    MeshCollider * welded = GetAssetMeshCollidersArena(FrameArena(), &asset, MatrixIdentity());
+    int rawHits, weldedHits;
+    float rawDepth, weldedDepth;
+    double rawTime = TimeQueries(raw, ground.meshCount, boxes, &rawHits, &rawDepth);
+    double weldedTime = TimeQueries(welded, ground.meshCount, boxes, &weldedHits, &weldedDepth);
+
+    if(rawHits != weldedHits || fabsf(rawDepth - weldedDepth) > 1e-3f * rawHits) {
+        printf("hull queries disagree: %d hits (depth %f) raw, %d hits (depth %f) welded\n", rawHits, rawDepth, weldedHits, weldedDepth);
+        return 1;
+    }
+
+    int rawVerts = 0, hullVerts = 0;
+    for(int m = 0; m < ground.meshCount; m ++) {
+        rawVerts += ground.meshes[m].vertexCount;
+        hullVerts += asset.hulls[m].count;
+    }
+
+    double hashStart = BenchNanoseconds();
+    uint64_t hash = HashFile(BENCH_ASSET);
+    double hashTime = BenchNanoseconds() - hashStart;
+
+    printf("ground: %d meshes, %d verts, %d welded, asset %.1f KB (hashes at %.0f MB/s, %016llx)\n", ground.meshCount, rawVerts, hullVerts,
+        asset.file.size / 1024.0, asset.file.size / (hashTime / 1e9) / (1024.0 * 1024.0), (unsigned long long)hash);
+    printf("%-24s %12s %12s %8s\n", "case", "old ms", "new ms", "speedup");
+    printf("%-24s %12.2f %12.2f %7.2fx\n", "build / open cached", bestBuild / 1e6, bestOpen / 1e6, bestBuild / bestOpen);
+    printf("%-24s %12.2f %12.2f %7.2fx\n", "20k box queries", rawTime / 1e6, weldedTime / 1e6, rawTime / weldedTime);
+
+    FrameArenaReset();
+    UnloadAssetModel(&asset);
+    UnloadModel(ground);
+    free(boxes);
+    remove(BENCH_ASSET);
+    CloseWindow();
+    return 0;
+}
@@ -0,0 +1,89 @@
+#ifndef _bench_common
+#define _bench_common
+
+#include "headers.h"
+#include "main.h"
+#include "collision.h"
+#include "actors.h"
+
+// fixtures the benches share. each bench is one .c file with its own main(), so this is included once per
+// program and the definitions can live here
+
+typedef struct BenchSprite {
+    int frame;
+} BenchSprite;
+
+ECS_COMPONENT_DECLARE(BenchSprite);
+
+static inline double BenchNanoseconds(void) {
+    return (double)ecs_os_now();
+}
+
+static inline float BenchRandom(float min, float max) {
+    return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+static inline float GroundHeight(float x, float y) {
+    return 0.5f * sinf(x * 0.7f) * cosf(y * 0.5f);
+}
+
+// cpu only mesh of quads * quads cells over GroundHeight, nothing is uploaded. normals point straight up
+static inline Mesh GenGroundTile(float x0, float y0, float size, int quads, bool normals) {
+    Mesh mesh = { 0 };
+    mesh.triangleCount = quads * quads * 2;
+    mesh.vertexCount = mesh.triangleCount * 3;
+    mesh.vertices = RL_MALLOC(sizeof(float) * 3 * mesh.vertexCount);
+    if(normals)
+        mesh.normals = RL_MALLOC(sizeof(float) * 3 * mesh.vertexCount);
+
+    float step = size / quads;
+    int v = 0;
+    for(int qy = 0; qy < quads; qy ++) {
+        for(int qx = 0; qx < quads; qx ++) {
+            float xs[2] = { x0 + qx * step, x0 + (qx + 1) * step };
+            float ys[2] = { y0 + qy * step, y0 + (qy + 1) * step };
+            int corners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+            for(int c = 0; c < 6; c ++) {
+                float x = xs[corners[c][0]];
+                float y = ys[corners[c][1]];
+                if(normals) {
+                    mesh.normals[v] = 0.0f;
+                    mesh.normals[v + 1] = 0.0f;
+                    mesh.normals[v + 2] = 1.0f;
+                }
+                mesh.vertices[v ++] = x;
+                mesh.vertices[v ++] = y;
+                mesh.vertices[v ++] = GroundHeight(x, y);
+            }
+        }
+    }
+    return mesh;
+}
+
+// a fresh world with the game's components and collider queries, and prefabCount small actor prefabs.
+// with sprites each prefab gets a BenchSprite, standing in for the game's billboards
+static inline void BenchWorld(ecs_entity_t * prefabs, int prefabCount, bool sprites) {
+    world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, CamDistance);
+    ECS_COMPONENT_DEFINE(world, Matrix);
+    ECS_COMPONENT_DEFINE(world, Model);
+    ECS_ACTOR_COMPONENTS();
+    ECS_COMPONENT_DEFINE(world, BenchSprite);
+
+    ECS_ASSET_PENDING();
+    ECS_COLLIDER_COMPONENTS();
+    ECS_COLLIDER_QUERIES();
+
+    ecs_entity_t smallActor = ecs_entity(world, { .add = ecs_ids( EcsPrefab ) });
+    ecs_set(world, smallActor, ActorShape, { { -ACTOR_SMALL_R, -ACTOR_SMALL_R, 0 }, { ACTOR_SMALL_R, ACTOR_SMALL_R, ACTOR_SMALL_H } });
+
+    for(int i = 0; i < prefabCount; i ++) {
+        prefabs[i] = ecs_entity(world, { .add = ecs_ids( EcsPrefab, ecs_isa(smallActor) ) });
+        if(sprites)
+            ecs_set(world, prefabs[i], BenchSprite, { i });
+    }
+}
+
+#endif
@@ -0,0 +1,288 @@
+#include "bench_common.h"
+#include "assets.h"
+
+// ns/op for every narrowphase and ray entry point, on the colliders in resources/: hit, miss and deep cases.
+// each case is warmed up, then timed as BENCH_SAMPLES batches, and the batches give the percentiles.
+// --json <file> writes the same numbers for tracking over time, "-" for stdout
+// run from the repo root: bin/Release/collision_bench [--json results.json]
+
+#define BENCH_WARMUP 2000
+#define BENCH_SAMPLES 101
+#define BENCH_BATCH 200         // calls per sample, one call is too short for the clock
+#define BENCH_CRATES 8          // per side, box colliders scattered over the map for the ray queries
+
+// the small shapes sit off the side of the map so rays at one don't pass through the other
+#define SHAPES_X 20.0f
+
+typedef enum BenchOp {
+    OP_BOX_MESH,
+    OP_POINT_MESH,
+    OP_MESH_MESH,
+    OP_BOX_BOX,
+    OP_RAY_MESHES,
+    OP_RAY_ANY,
+} BenchOp;
+
+typedef struct BenchCase {
+    const char * name;
+    BenchOp op;
+    MeshCollider meshA;
+    MeshCollider meshB;
+    BoundingBox boxA;
+    BoundingBox boxB;
+    Vector3 point;
+    Ray ray;
+
+    // filled in by TimeCase
+    bool hit;
+    double min, p50, p90, p99, max, mean;      // ns/op
+} BenchCase;
+
+int CompareDouble(const void * a, const void * b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+bool RunCase(const BenchCase * bc) {
+    switch(bc->op) {
+        case OP_BOX_MESH:
+            return BoxMeshCollision(bc->boxA, bc->meshA).hit;
+        case OP_POINT_MESH:
+            return PointMeshCollision(bc->point, bc->meshA).hit;
+        case OP_MESH_MESH:
+            return MeshCollision(bc->meshA, bc->meshB).hit;
+        case OP_BOX_BOX:
+            return BoxBoxCollision(bc->boxA, bc->boxB).hit;
+        case OP_RAY_MESHES:
+            return RayToMeshColliders(bc->ray, FLT_MAX).hit;
+        case OP_RAY_ANY:
+            return RayToAnyCollider(bc->ray, FLT_MAX).hit;
+    }
+    return false;
+}
+
+void TimeCase(BenchCase * bc) {
+    // keeps the calls from being thrown away
+    volatile int hits = 0;
+
+    for(int i = 0; i < BENCH_WARMUP; i ++) {
+        hits += RunCase(bc);
+        if(i % BENCH_BATCH == 0)
+            FrameArenaReset();
+    }
+    FrameArenaReset();
+
+    double samples[BENCH_SAMPLES];
+    double total = 0;
+    for(int s = 0; s < BENCH_SAMPLES; s ++) {
+        double start = BenchNanoseconds();
+        for(int i = 0; i < BENCH_BATCH; i ++) {
+            hits += RunCase(bc);
+        }
+        samples[s] = (BenchNanoseconds() - start) / BENCH_BATCH;
+        total += samples[s];
+
+        // the mesh queries take their vertices from the frame arena, the game gives it back every frame
+        FrameArenaReset();
+    }
+    qsort(samples, BENCH_SAMPLES, sizeof(double), CompareDouble);
+
+    bc->hit = RunCase(bc);
+    bc->min = samples[0];
+    bc->p50 = samples[BENCH_SAMPLES * 50 / 100];
+    bc->p90 = samples[BENCH_SAMPLES * 90 / 100];
+    bc->p99 = samples[BENCH_SAMPLES * 99 / 100];
+    bc->max = samples[BENCH_SAMPLES - 1];
+    bc->mean = total / BENCH_SAMPLES;
+    FrameArenaReset();
+}
+
+bool WriteJson(FILE * file, const BenchCase * cases, int caseCount) {
+    fprintf(file, "{\n");
+    fprintf(file, "  \"benchmark\": \"collision_bench\",\n");
+    fprintf(file, "  \"unit\": \"ns/op\",\n");
+    fprintf(file, "  \"warmup\": %d,\n  \"samples\": %d,\n  \"batch\": %d,\n", BENCH_WARMUP, BENCH_SAMPLES, BENCH_BATCH);
+    fprintf(file, "  \"cases\": [\n");
+    for(int i = 0; i < caseCount; i ++) {
+        const BenchCase * bc = &cases[i];
+        fprintf(file, "    { \"name\": \"%s\", \"hit\": %s, \"min\": %.1f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f, \"mean\": %.1f }%s\n",
+            bc->name, bc->hit ? "true" : "false", bc->min, bc->p50, bc->p90, bc->p99, bc->max, bc->mean, i + 1 < caseCount ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return !ferror(file);
+}
+
+BoundingBox ActorBoxAt(float x, float y, float z) {
+    return (BoundingBox){ { x - ACTOR_SMALL_R, y - ACTOR_SMALL_R, z }, { x + ACTOR_SMALL_R, y + ACTOR_SMALL_R, z + ACTOR_SMALL_H } };
+}
+
+Matrix ShapeTransform(float x, float y, float z) {
+    return MatrixTranslate(SHAPES_X + x, y, z);
+}
+
+void AddMeshColliders(const MeshCollider * colliders, int count) {
+    for(int i = 0; i < count; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set_ptr(world, e, MeshCollider, &colliders[i]);
+    }
+}
+
+int main(int argc, char ** argv) {
+    ecs_os_set_api_defaults();
+
+    const char * jsonPath = NULL;
+    for(int i = 1; i < argc; i ++) {
+        if(strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++ i];
+        else {
+            printf("usage: collision_bench [--json <file>|-]\n");
+            return 1;
+        }
+    }
+
+    // opened before the working directory moves to resources/
+    FILE * json = NULL;
+    if(jsonPath != NULL) {
+        json = strcmp(jsonPath, "-") == 0 ? stdout : fopen(jsonPath, "w");
+        if(json == NULL) {
+            printf("couldn't write %s\n", jsonPath);
+            return 1;
+        }
+    }
+
+    // models upload on load, so they need a context
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(64, 64, "collision_bench");
+    if(!SearchAndSetResourceDir("resources")) {
+        printf("run from the repo root, resources/ not found\n");
+        return 1;
+    }
+
+    world = ecs_init();
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Matrix);
+    ECS_ACTOR_COMPONENTS();
+    ECS_ASSET_PENDING();
+    ECS_COLLIDER_COMPONENTS();
+    ECS_COLLIDER_QUERIES();
+
+    // the map goes through the asset cache like the game's, so its colliders have welded hulls
+    AssetModel map = LoadAssetModel("map1.glb");
+    Model icosphere = LoadModel("icosphere.glb");
+    Model cylinder = LoadModel("cylinder.glb");
+    Model cubic = LoadModel("cubic.glb");
+    if(map.model.meshCount == 0 || icosphere.meshCount == 0 || cylinder.meshCount == 0 || cubic.meshCount == 0) {
+        printf("couldn't load the colliders from resources/\n");
+        return 1;
+    }
+
+    // the world the ray queries walk: map, shapes, and a grid of crates over the map
+    MeshCollider * mapColliders = GetAssetMeshCollidersArena(FrameArena(), &map, MatrixIdentity());
+    AddMeshColliders(mapColliders, map.model.meshCount);
+
+    MeshCollider ico = MakeMeshCollider(&icosphere.meshes[0], ShapeTransform(0, 0, 0));
+    MeshCollider cyl = MakeMeshCollider(&cylinder.meshes[0], ShapeTransform(2.5f, 0, 0));
+    MeshCollider cub = MakeMeshCollider(&cubic.meshes[0], ShapeTransform(6.0f, 0, 0));
+    AddMeshColliders(&ico, 1);
+    AddMeshColliders(&cyl, 1);
+    AddMeshColliders(&cub, 1);
+
+    for(int y = 0; y < BENCH_CRATES; y ++) {
+        for(int x = 0; x < BENCH_CRATES; x ++) {
+            float cx = -7.0f + 14.0f * x / (BENCH_CRATES - 1);
+            float cy = -7.0f + 14.0f * y / (BENCH_CRATES - 1);
+            BoundingBox crate = { { cx - 0.25f, cy - 0.25f, 6.0f }, { cx + 0.25f, cy + 0.25f, 6.5f } };
+            ecs_entity_t e = ecs_new(world);
+            ecs_set_ptr(world, e, BoxCollider, &crate);
+        }
+    }
+
+    // find the map's ground under the middle, and which mesh it's on, for a box resting on it
+    Ray downRay = { { 0.1f, 0.1f, 20.0f }, { 0, 0, -1 } };
+    RayCollision groundHit = RayToMeshColliders(downRay, FLT_MAX);
+    float groundZ = groundHit.hit ? groundHit.point.z : 0.0f;
+    MeshCollider ground = mapColliders[0];
+    for(int i = 0; i < map.model.meshCount; i ++) {
+        BoundingBox box = mapColliders[i].worldBox;
+        if(downRay.position.x >= box.min.x && downRay.position.x <= box.max.x && downRay.position.y >= box.min.y && downRay.position.y <= box.max.y &&
+            groundZ >= box.min.z - 0.001f && groundZ <= box.max.z + 0.001f) {
+            ground = mapColliders[i];
+            break;
+        }
+    }
+    FrameArenaReset();
+
+    // other placements of the cylinder against the icosphere
+    MeshCollider cylShallow = MakeMeshCollider(&cylinder.meshes[0], ShapeTransform(1.8f, 0, 0));
+    MeshCollider cylDeep = MakeMeshCollider(&cylinder.meshes[0], ShapeTransform(0.5f, 0, 0));
+    MeshCollider cylMiss = MakeMeshCollider(&cylinder.meshes[0], ShapeTransform(1.6f, 1.6f, 1.6f));
+
+    BoundingBox groundBox = { { -8.0f, -8.0f, -1.0f }, { 8.0f, 8.0f, 0.0f } };
+    float sx = SHAPES_X;
+
+    BenchCase cases[] = {
+        { "box/mesh icosphere shallow", OP_BOX_MESH, .meshA = ico, .boxA = ActorBoxAt(sx, 0, 0.99f) },
+        { "box/mesh icosphere deep", OP_BOX_MESH, .meshA = ico, .boxA = ActorBoxAt(sx, 0, 0.3f) },
+        { "box/mesh icosphere miss", OP_BOX_MESH, .meshA = ico, .boxA = ActorBoxAt(sx + 0.8f, 0.8f, 0.8f) },
+        { "box/mesh icosphere far", OP_BOX_MESH, .meshA = ico, .boxA = ActorBoxAt(sx, 0, 3.0f) },
+        { "box/mesh cubic deep", OP_BOX_MESH, .meshA = cub, .boxA = ActorBoxAt(sx + 6.0f, 0, -0.2f) },
+        { "box/mesh map resting", OP_BOX_MESH, .meshA = ground, .boxA = ActorBoxAt(downRay.position.x, downRay.position.y, groundZ - 0.005f) },
+        { "box/mesh map above", OP_BOX_MESH, .meshA = ground, .boxA = ActorBoxAt(downRay.position.x, downRay.position.y, groundZ + 0.5f) },
+
+        { "point/mesh icosphere shallow", OP_POINT_MESH, .meshA = ico, .point = { sx, 0, 0.98f } },
+        { "point/mesh icosphere deep", OP_POINT_MESH, .meshA = ico, .point = { sx + 0.1f, 0, 0.2f } },
+        { "point/mesh icosphere miss", OP_POINT_MESH, .meshA = ico, .point = { sx + 0.8f, 0.8f, 0.8f } },
+        { "point/mesh map resting", OP_POINT_MESH, .meshA = ground, .point = { downRay.position.x, downRay.position.y, groundZ - 0.005f } },
+
+        { "mesh/mesh ico-cyl shallow", OP_MESH_MESH, .meshA = ico, .meshB = cylShallow },
+        { "mesh/mesh ico-cyl deep", OP_MESH_MESH, .meshA = ico, .meshB = cylDeep },
+        { "mesh/mesh ico-cyl miss", OP_MESH_MESH, .meshA = ico, .meshB = cylMiss },
+        { "mesh/mesh ico-cyl far", OP_MESH_MESH, .meshA = ico, .meshB = cyl },
+
+#ifdef NDEBUG
+        // BoxBoxCollision asserts on a hit in debug builds
+        { "box/box resting", OP_BOX_BOX, .boxA = groundBox, .boxB = ActorBoxAt(0, 0, -0.005f) },
+        { "box/box deep", OP_BOX_BOX, .boxA = groundBox, .boxB = ActorBoxAt(0, 0, -0.5f) },
+#endif
+        { "box/box miss", OP_BOX_BOX, .boxA = groundBox, .boxB = ActorBoxAt(0, 0, 1.0f) },
+
+        { "ray/meshes map down", OP_RAY_MESHES, .ray = downRay },
+        { "ray/meshes icosphere", OP_RAY_MESHES, .ray = { { sx, 0, 10.0f }, { 0, 0, -1 } } },
+        { "ray/meshes from below", OP_RAY_MESHES, .ray = { { 0.1f, 0.1f, -5.0f }, { 0, 0, 1 } } },
+        { "ray/meshes sky", OP_RAY_MESHES, .ray = { { 0.1f, 0.1f, 20.0f }, { 0, 0, 1 } } },
+
+        { "ray/any crate", OP_RAY_ANY, .ray = { { -7.0f, -7.0f, 20.0f }, { 0, 0, -1 } } },
+        { "ray/any map down", OP_RAY_ANY, .ray = downRay },
+        { "ray/any sky", OP_RAY_ANY, .ray = { { 0.1f, 0.1f, 20.0f }, { 0, 0, 1 } } },
+    };
+    int caseCount = sizeof(cases) / sizeof(cases[0]);
+
+    // the table moves out of the way when the json goes to stdout
+    FILE * table = json == stdout ? stderr : stdout;
+    fprintf(table, "%-30s %5s %10s %10s %10s %10s %10s\n", "case (ns/op)", "hit", "min", "p50", "p90", "p99", "max");
+    for(int i = 0; i < caseCount; i ++) {
+        TimeCase(&cases[i]);
+        BenchCase * bc = &cases[i];
+        fprintf(table, "%-30s %5s %10.1f %10.1f %10.1f %10.1f %10.1f\n", bc->name, bc->hit ? "yes" : "no", bc->min, bc->p50, bc->p90, bc->p99, bc->max);
+    }
+
+    bool ok = true;
+    if(json != NULL) {
+        ok = WriteJson(json, cases, caseCount);
+        if(json != stdout)
+            ok = fclose(json) == 0 && ok;
+        if(!ok)
+            printf("couldn't write %s\n", jsonPath);
+    }
+
+    ecs_fini(world);
+    UnloadAssetModel(&map);
+    UnloadModel(icosphere);
+    UnloadModel(cylinder);
+    UnloadModel(cubic);
+    CloseWindow();
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+#include "bench_common.h"
+#include "list.h"
+
+// vector/objpool/ring against the old list.h macros (kept here just for this) and plain malloc
+// run from the repo root: bin/Release/container_bench
+
+#define BENCH_REPEATS 20
+#define PUSH_COUNT 1000000
+#define SMALL_LISTS 10000
+#define SMALL_LIST_SIZE 6
+#define POOL_OBJECTS 10000
+#define RING_SIZE 256
+
+typedef struct BenchObject {
+    Vector3 position;
+    Vector3 velocity;
+    int id;
+} BenchObject;
+
+// Vector3 like the hot paths would store. with int elements every store can alias the size field,
+// so a vector (whose inline buffer pins it in memory) reloads it each push and runs about 2x behind list.h
+DECLARE_LIST(Vector3);
+DECLARE_VECTOR(Vector3, 16);
+DECLARE_OBJPOOL(BenchObject);
+DECLARE_RING(int, RING_SIZE);
+
+// keeps results alive so the loops aren't optimized out
+volatile int64_t benchSink;
+
+void PrintRow(const char * name, double oldTime, double newTime, int ops) {
+    printf("%-24s %14.2f %14.2f %8.2fx\n", name, oldTime / ops, newTime / ops, oldTime / newTime);
+}
+
+double PushList(void) {
+    double start = BenchNanoseconds();
+    LIST_(Vector3) list = NEWLIST(Vector3);
+    for(int i = 0; i < PUSH_COUNT; i ++) {
+        LIST_ADD(list, ((Vector3){ i, i, i }));
+    }
+    int64_t sum = 0;
+    for(int i = 0; i < list.size; i ++) {
+        sum += LIST_GET(list, i).x;
+    }
+    benchSink = sum;
+    FREELIST(list);
+    return BenchNanoseconds() - start;
+}
+
+double PushVector(bool reserve) {
+    double start = BenchNanoseconds();
+    VECTOR_(Vector3) vec = NEWVECTOR(Vector3);
+    if(reserve)
+        VECTOR_RESERVE(vec, PUSH_COUNT);
+    for(int i = 0; i < PUSH_COUNT; i ++) {
+        VECTOR_PUSH(vec, ((Vector3){ i, i, i }));
+    }
+    int64_t sum = 0;
+    for(int i = 0; i < vec.size; i ++) {
+        sum += VECTOR_GET(vec, i).x;
+    }
+    benchSink = sum;
+    FREEVECTOR(vec);
+    return BenchNanoseconds() - start;
+}
+
+// lots of short lists, where the vector never leaves its inline buffer
+double SmallLists(void) {
+    double start = BenchNanoseconds();
+    int64_t sum = 0;
+    for(int l = 0; l < SMALL_LISTS; l ++) {
+        LIST_(Vector3) list = NEWLIST(Vector3);
+        for(int i = 0; i < SMALL_LIST_SIZE; i ++) {
+            LIST_ADD(list, ((Vector3){ i, i, i }));
+        }
+        sum += LIST_GET(list, SMALL_LIST_SIZE - 1).x;
+        FREELIST(list);
+    }
+    benchSink = sum;
+    return BenchNanoseconds() - start;
+}
+
+double SmallVectors(void) {
+    double start = BenchNanoseconds();
+    int64_t sum = 0;
+    for(int l = 0; l < SMALL_LISTS; l ++) {
+        VECTOR_(Vector3) vec = NEWVECTOR(Vector3);
+        for(int i = 0; i < SMALL_LIST_SIZE; i ++) {
+            VECTOR_PUSH(vec, ((Vector3){ i, i, i }));
+        }
+        sum += VECTOR_GET(vec, SMALL_LIST_SIZE - 1).x;
+        FREEVECTOR(vec);
+    }
+    benchSink = sum;
+    return BenchNanoseconds() - start;
+}
+
+// fill, free every other object, refill the holes
+double ChurnMalloc(void) {
+    static BenchObject * objects[POOL_OBJECTS];
+    double start = BenchNanoseconds();
+    for(int i = 0; i < POOL_OBJECTS; i ++) {
+        objects[i] = malloc(sizeof(BenchObject));
+        objects[i]->id = i;
+    }
+    for(int i = 0; i < POOL_OBJECTS; i += 2) {
+        free(objects[i]);
+        objects[i] = malloc(sizeof(BenchObject));
+        objects[i]->id = -i;
+    }
+    int64_t sum = 0;
+    for(int i = 0; i < POOL_OBJECTS; i ++) {
+        sum += objects[i]->id;
+        free(objects[i]);
+    }
+    benchSink = sum;
+    return BenchNanoseconds() - start;
+}
+
+double ChurnObjPool(void) {
+    static Handle handles[POOL_OBJECTS];
+    double start = BenchNanoseconds();
+    OBJPOOL_(BenchObject) pool = NEWOBJPOOL(BenchObject);
+    for(int i = 0; i < POOL_OBJECTS; i ++) {
+        handles[i] = OBJPOOL_ALLOC(pool);
+        OBJPOOL_GET(pool, handles[i])->id = i;
+    }
+    for(int i = 0; i < POOL_OBJECTS; i += 2) {
+        OBJPOOL_FREE(pool, handles[i]);
+        handles[i] = OBJPOOL_ALLOC(pool);
+        OBJPOOL_GET(pool, handles[i])->id = -i;
+    }
+    int64_t sum = 0;
+    for(int i = 0; i < POOL_OBJECTS; i ++) {
+        sum += OBJPOOL_GET(pool, handles[i])->id;
+    }
+    benchSink = sum;
+    FREEOBJPOOL(pool);
+    return BenchNanoseconds() - start;
+}
+
+// queue traffic: list as a shifting queue against the ring
+DECLARE_LIST(int);
+
+double QueueList(void) {
+    double start = BenchNanoseconds();
+    LIST_(int) list = NEWLIST(int);
+    int64_t sum = 0;
+    for(int i = 0; i < PUSH_COUNT; i ++) {
+        LIST_ADD(list, i);
+        if(list.size == RING_SIZE) {
+            sum += LIST_GET(list, 0);
+            memmove(list.arr, list.arr + 1, sizeof(int) * (list.size - 1));
+            list.size --;
+        }
+    }
+    benchSink = sum;
+    FREELIST(list);
+    return BenchNanoseconds() - start;
+}
+
+double QueueRing(void) {
+    double start = BenchNanoseconds();
+    RING_(int) ring = NEWRING(int);
+    int64_t sum = 0;
+    for(int i = 0; i < PUSH_COUNT; i ++) {
+        RING_PUSH(ring, i);
+        if(RING_FULL(ring)) {
+            int out;
+            RING_POP(ring, out);
+            sum += out;
+        }
+    }
+    benchSink = sum;
+    return BenchNanoseconds() - start;
+}
+
+// best of BENCH_REPEATS
+double Best(double (*run)(void)) {
+    double best = run();
+    for(int i = 1; i < BENCH_REPEATS; i ++) {
+        double t = run();
+        if(t < best)
+            best = t;
+    }
+    return best;
+}
+
+double PushVectorGrow(void) {
+    return PushVector(false);
+}
+
+double PushVectorReserved(void) {
+    return PushVector(true);
+}
+
+int main(void) {
+    ecs_os_set_api_defaults();
+
+    printf("%-24s %14s %14s %8s\n", "case", "old ns/op", "new ns/op", "speedup");
+    double listPush = Best(PushList);
+    PrintRow("push 1M (grow)", listPush, Best(PushVectorGrow), PUSH_COUNT);
+    PrintRow("push 1M (reserved)", listPush, Best(PushVectorReserved), PUSH_COUNT);
+    PrintRow("10k lists of 6", Best(SmallLists), Best(SmallVectors), SMALL_LISTS * SMALL_LIST_SIZE);
+    PrintRow("objects: malloc/pool", Best(ChurnMalloc), Best(ChurnObjPool), POOL_OBJECTS + POOL_OBJECTS / 2);
+    PrintRow("queue: list/ring", Best(QueueList), Best(QueueRing), PUSH_COUNT);
+
+    return 0;
+}
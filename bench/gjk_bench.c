@@ -0,0 +1,146 @@
+#include "bench_common.h"
+
+// in-tree GJK/EPA against ccdGJKPenetration on the shape pairs the game uses
+// run from the repo root: bin/Release/gjk_bench
+
+#define BENCH_WARMUP 1000
+#define BENCH_ITERATIONS 100000
+#define SPHERE_VERTS 162        // same count as an icosphere with 2 subdivisions
+
+typedef Collision (*PenetrationFunc)(const void * a, const void * b);
+typedef bool (*IntersectFunc)(const void * a, const void * b);
+
+typedef struct BenchCase {
+    const char * name;
+    const void * a;
+    const void * b;
+    ccd_support_fn ccdSupportA;
+    ccd_support_fn ccdSupportB;
+    PenetrationFunc penetration;
+} BenchCase;
+
+double TimeCCD(BenchCase * bc, Collision * out) {
+    for(int i = 0; i < BENCH_WARMUP; i ++) {
+        *out = CCDPenetration(bc->a, bc->ccdSupportA, bc->b, bc->ccdSupportB);
+    }
+    double start = BenchNanoseconds();
+    for(int i = 0; i < BENCH_ITERATIONS; i ++) {
+        *out = CCDPenetration(bc->a, bc->ccdSupportA, bc->b, bc->ccdSupportB);
+    }
+    return (BenchNanoseconds() - start) / BENCH_ITERATIONS;
+}
+
+double TimeGJK(BenchCase * bc, Collision * out) {
+    for(int i = 0; i < BENCH_WARMUP; i ++) {
+        *out = bc->penetration(bc->a, bc->b);
+    }
+    double start = BenchNanoseconds();
+    for(int i = 0; i < BENCH_ITERATIONS; i ++) {
+        *out = bc->penetration(bc->a, bc->b);
+    }
+    return (BenchNanoseconds() - start) / BENCH_ITERATIONS;
+}
+
+// intersect, MPR estimate and EPA on the same pair
+typedef struct TierCase {
+    const char * name;
+    const void * a;
+    const void * b;
+    IntersectFunc intersect;
+    PenetrationFunc estimate;
+    PenetrationFunc exact;
+} TierCase;
+
+double TimeIntersect(TierCase * tc, bool * out) {
+    for(int i = 0; i < BENCH_WARMUP; i ++) {
+        *out = tc->intersect(tc->a, tc->b);
+    }
+    double start = BenchNanoseconds();
+    for(int i = 0; i < BENCH_ITERATIONS; i ++) {
+        *out = tc->intersect(tc->a, tc->b);
+    }
+    return (BenchNanoseconds() - start) / BENCH_ITERATIONS;
+}
+
+double TimePenetration(TierCase * tc, PenetrationFunc penetration, Collision * out) {
+    for(int i = 0; i < BENCH_WARMUP; i ++) {
+        *out = penetration(tc->a, tc->b);
+    }
+    double start = BenchNanoseconds();
+    for(int i = 0; i < BENCH_ITERATIONS; i ++) {
+        *out = penetration(tc->a, tc->b);
+    }
+    return (BenchNanoseconds() - start) / BENCH_ITERATIONS;
+}
+
+int main(void) {
+    ecs_os_set_api_defaults();
+
+    // unit sphere point cloud standing in for a map mesh
+    Vector3 sphereVerts[SPHERE_VERTS];
+    for(int i = 0; i < SPHERE_VERTS; i ++) {
+        float z = 1.0f - 2.0f * (i + 0.5f) / SPHERE_VERTS;
+        float r = sqrtf(1.0f - z*z);
+        float theta = i * 2.3999632f;
+        sphereVerts[i] = (Vector3){ r * cosf(theta), r * sinf(theta), z };
+    }
+    VertexMesh sphere = { sphereVerts, SPHERE_VERTS };
+
+    BoundingBox actorShallow = { { -ACTOR_SMALL_R, -ACTOR_SMALL_R, 0.99f }, { ACTOR_SMALL_R, ACTOR_SMALL_R, 0.99f + ACTOR_SMALL_H } };
+    BoundingBox actorDeep = { { -ACTOR_SMALL_R, -ACTOR_SMALL_R, 0.5f }, { ACTOR_SMALL_R, ACTOR_SMALL_R, 0.5f + ACTOR_SMALL_H } };
+    BoundingBox actorMiss = { { 0.8f, 0.8f, 0.8f }, { 0.8f + 2*ACTOR_SMALL_R, 0.8f + 2*ACTOR_SMALL_R, 0.8f + ACTOR_SMALL_H } };
+    BoundingBox ground = { { -8.0f, -8.0f, -1.0f }, { 8.0f, 8.0f, 0.0f } };
+    BoundingBox actorOnGround = { { -ACTOR_SMALL_R, -ACTOR_SMALL_R, -0.005f }, { ACTOR_SMALL_R, ACTOR_SMALL_R, ACTOR_SMALL_H - 0.005f } };
+    Vector3 pointShallow = { 0.0f, 0.0f, 0.98f };
+    Vector3 pointDeep = { 0.1f, 0.0f, 0.2f };
+
+    BenchCase cases[] = {
+        { "box/mesh shallow", &sphere, &actorShallow, VertexMeshSupport, BoundingBoxSupport, VertexMeshBoxPenetration },
+        { "box/mesh deep", &sphere, &actorDeep, VertexMeshSupport, BoundingBoxSupport, VertexMeshBoxPenetration },
+        { "box/mesh miss", &sphere, &actorMiss, VertexMeshSupport, BoundingBoxSupport, VertexMeshBoxPenetration },
+        { "point/mesh shallow", &sphere, &pointShallow, VertexMeshSupport, PointSupport, VertexMeshPointPenetration },
+        { "point/mesh deep", &sphere, &pointDeep, VertexMeshSupport, PointSupport, VertexMeshPointPenetration },
+        { "mesh/mesh", &sphere, &sphere, VertexMeshSupport, VertexMeshSupport, VertexMeshVertexMeshPenetration },
+        { "box/box resting", &ground, &actorOnGround, BoundingBoxSupport, BoundingBoxSupport, BoxBoxPenetration },
+    };
+    int caseCount = sizeof(cases) / sizeof(cases[0]);
+
+    printf("%-20s %12s %12s %8s %12s\n", "case", "ccd ns/op", "gjk ns/op", "speedup", "depth diff");
+    for(int i = 0; i < caseCount; i ++) {
+        Collision ccdResult, gjkResult;
+        double ccdTime = TimeCCD(&cases[i], &ccdResult);
+        double gjkTime = TimeGJK(&cases[i], &gjkResult);
+
+        float depthDiff = fabsf((ccdResult.hit ? ccdResult.depth : 0.0f) - (gjkResult.hit ? gjkResult.depth : 0.0f));
+        printf("%-20s %12.1f %12.1f %7.2fx %12.6f%s\n", cases[i].name, ccdTime, gjkTime, ccdTime / gjkTime, depthDiff,
+            ccdResult.hit != gjkResult.hit ? "  HIT MISMATCH" : "");
+    }
+
+    TierCase tiers[] = {
+        { "box/mesh shallow", &sphere, &actorShallow, VertexMeshBoxIntersect, VertexMeshBoxPenetrationMPR, VertexMeshBoxPenetration },
+        { "box/mesh deep", &sphere, &actorDeep, VertexMeshBoxIntersect, VertexMeshBoxPenetrationMPR, VertexMeshBoxPenetration },
+        { "box/mesh miss", &sphere, &actorMiss, VertexMeshBoxIntersect, VertexMeshBoxPenetrationMPR, VertexMeshBoxPenetration },
+        { "point/mesh shallow", &sphere, &pointShallow, VertexMeshPointIntersect, VertexMeshPointPenetrationMPR, VertexMeshPointPenetration },
+        { "point/mesh deep", &sphere, &pointDeep, VertexMeshPointIntersect, VertexMeshPointPenetrationMPR, VertexMeshPointPenetration },
+    };
+    int tierCount = sizeof(tiers) / sizeof(tiers[0]);
+
+    printf("\n%-20s %12s %12s %12s %12s %10s\n", "case", "gjk ns/op", "mpr ns/op", "epa ns/op", "depth diff", "angle");
+    for(int i = 0; i < tierCount; i ++) {
+        bool intersect;
+        Collision estimate, exact;
+        double intersectTime = TimeIntersect(&tiers[i], &intersect);
+        double estimateTime = TimePenetration(&tiers[i], tiers[i].estimate, &estimate);
+        double exactTime = TimePenetration(&tiers[i], tiers[i].exact, &exact);
+
+        float depthDiff = 0.0f, angle = 0.0f;
+        if(estimate.hit && exact.hit) {
+            depthDiff = estimate.depth - exact.depth;
+            angle = Vector3Angle(estimate.direction, exact.direction) * RAD2DEG;
+        }
+        printf("%-20s %12.1f %12.1f %12.1f %12.6f %10.2f%s\n", tiers[i].name, intersectTime, estimateTime, exactTime, depthDiff, angle,
+            (intersect != exact.hit || estimate.hit != exact.hit) ? "  HIT MISMATCH" : "");
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "bench_common.h"
+
+// IntegrateActors against the per actor velocity code it replaced
+// run from the repo root: bin/Release/physics_bench
+
+#define BENCH_REPEATS 20
+#define BENCH_ACTORS 100000
+#define BENCH_FRAMES 10
+#define CHECK_FRAMES 200
+
+// ActorFriction / ActorAccelerate and the grounded branch from ActorPhysics, one actor at a time.
+// the ground clip is ClipVector minus its debug DrawRay, there's no window here
+void FrictionScalar(Velocity * velocity) {
+    float speed = Vector3Length(*velocity);
+    if(speed < ACTOR_MIN_SPEED) {
+        velocity->x = 0;
+        velocity->y = 0;
+        velocity->z = 0;
+        return;
+    }
+
+    float newSpeed = speed - ACTOR_FRICTION;
+    if(newSpeed < 0)
+        newSpeed = 0;
+
+    velocity->x *= newSpeed/speed;
+    velocity->y *= newSpeed/speed;
+    velocity->z *= newSpeed/speed;
+}
+
+void AccelerateScalar(Velocity * velocity, Vector3 movedir, bool grounded) {
+    Vector3 velocityXY = V2toV3((*velocity), 0);
+    float currentSpeed = Vector3DotProduct(velocityXY, movedir);
+    float maxSpeed = grounded ? ACTOR_MAX_SPEED : ACTOR_AIR_MAX_SPEED;
+
+    float addspeed = maxSpeed - currentSpeed;
+    if(addspeed <= 0)
+        return;
+    float accel = ACTOR_ACCEL > addspeed ? addspeed : ACTOR_ACCEL;
+
+    *velocity = Vector3Add(*velocity, Vector3Scale(movedir, accel));
+}
+
+void IntegrateActorsScalar(Velocity * velocity, GroundState * ground, const bool * groundHit, int count, Vector2 movedir, bool jump) {
+    for(int i = 0; i < count; i ++) {
+        if(groundHit[i])
+            ground[i].grounded = ACTOR_GROUND_TIME;
+        else
+            velocity[i] = Vector3Add(velocity[i], gravity);
+
+        if(ground[i].grounded > 0) {
+            FrictionScalar(&velocity[i]);
+            AccelerateScalar(&velocity[i], V2toV3(movedir, 0), true);
+
+            if(velocity[i].z < -ACTOR_MAX_SPEED)
+                velocity[i].z = -ACTOR_MAX_SPEED;
+
+            if(ground[i].grounded == ACTOR_GROUND_TIME) {
+                float backoff = Vector3DotProduct(velocity[i], ground[i].groundNormal);
+                velocity[i] = Vector3Subtract(velocity[i], Vector3Scale(ground[i].groundNormal, backoff));
+            }
+
+            if(jump) {
+                velocity[i] = Vector3Add(velocity[i], Vector3Scale(up, 0.5f));
+                ground[i].grounded = 0;
+            }
+        }
+        else {
+            AccelerateScalar(&velocity[i], V2toV3(movedir, 0), false);
+        }
+
+        ground[i].grounded --;
+    }
+}
+
+typedef void (*IntegrateFunc)(Velocity *, GroundState *, const bool *, int, Vector2, bool);
+
+// a mix of standing, falling and just landed actors, some slow enough to stop dead
+void FillActors(Velocity * velocity, GroundState * ground, bool * groundHit, int count) {
+    for(int i = 0; i < count; i ++) {
+        float scale = (i % 7 == 0) ? ACTOR_MIN_SPEED : ACTOR_MAX_SPEED;
+        velocity[i] = (Velocity){ BenchRandom(-scale, scale), BenchRandom(-scale, scale), BenchRandom(-scale, scale) };
+        ground[i].grounded = rand() % (ACTOR_GROUND_TIME + 3) - 2;
+        ground[i].groundNormal = Vector3Normalize((Vector3){ BenchRandom(-0.3f, 0.3f), BenchRandom(-0.3f, 0.3f), 1.0f });
+        groundHit[i] = rand() % 3 != 0;
+    }
+}
+
+Vector2 FrameMove(int frame) {
+    return Vector2Normalize((Vector2){ cosf(frame * 0.1f), sinf(frame * 0.1f) });
+}
+
+double TimeIntegrate(IntegrateFunc integrate, const Velocity * startVelocity, const GroundState * startGround, const bool * groundHit,
+    Velocity * velocity, GroundState * ground) {
+    double best = 0;
+    for(int r = 0; r < BENCH_REPEATS; r ++) {
+        memcpy(velocity, startVelocity, sizeof(Velocity) * BENCH_ACTORS);
+        memcpy(ground, startGround, sizeof(GroundState) * BENCH_ACTORS);
+
+        double start = (double)ecs_os_now();
+        for(int f = 0; f < BENCH_FRAMES; f ++) {
+            integrate(velocity, ground, groundHit, BENCH_ACTORS, FrameMove(f), f == BENCH_FRAMES / 2);
+        }
+        double t = (double)ecs_os_now() - start;
+        if(r == 0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+int main(void) {
+    ecs_os_set_api_defaults();
+
+    Velocity * startVelocity = malloc(sizeof(Velocity) * BENCH_ACTORS);
+    GroundState * startGround = malloc(sizeof(GroundState) * BENCH_ACTORS);
+    bool * groundHit = malloc(sizeof(bool) * BENCH_ACTORS);
+    Velocity * velocity = malloc(sizeof(Velocity) * BENCH_ACTORS);
+    GroundState * ground = malloc(sizeof(GroundState) * BENCH_ACTORS);
+    Velocity * checkVelocity = malloc(sizeof(Velocity) * BENCH_ACTORS);
+    GroundState * checkGround = malloc(sizeof(GroundState) * BENCH_ACTORS);
+
+    FillActors(startVelocity, startGround, groundHit, BENCH_ACTORS);
+
+    // both have to agree bit for bit, odd count so the padded tail block runs too
+    int checkCount = 1001;
+    memcpy(velocity, startVelocity, sizeof(Velocity) * checkCount);
+    memcpy(ground, startGround, sizeof(GroundState) * checkCount);
+    memcpy(checkVelocity, startVelocity, sizeof(Velocity) * checkCount);
+    memcpy(checkGround, startGround, sizeof(GroundState) * checkCount);
+    for(int f = 0; f < CHECK_FRAMES; f ++) {
+        IntegrateActorsScalar(checkVelocity, checkGround, groundHit, checkCount, FrameMove(f), f % 50 == 25);
+        IntegrateActors(velocity, ground, groundHit, checkCount, FrameMove(f), f % 50 == 25);
+    }
+    if(memcmp(velocity, checkVelocity, sizeof(Velocity) * checkCount) != 0 || memcmp(ground, checkGround, sizeof(GroundState) * checkCount) != 0) {
+        printf("IntegrateActors doesn't match the scalar path\n");
+        return 1;
+    }
+
+    double scalar = TimeIntegrate(IntegrateActorsScalar, startVelocity, startGround, groundHit, velocity, ground);
+    double simd = TimeIntegrate(IntegrateActors, startVelocity, startGround, groundHit, velocity, ground);
+
+    double updates = (double)BENCH_ACTORS * BENCH_FRAMES;
+    printf("%-20s %12s %16s\n", "integrate 100k x10", "ms", "actors/sec");
+    printf("%-20s %12.2f %16.0f\n", "per actor", scalar / 1e6, updates / (scalar / 1e9));
+    printf("%-20s %12.2f %16.0f\n", "IntegrateActors", simd / 1e6, updates / (simd / 1e9));
+    printf("speedup %.2fx\n", scalar / simd);
+
+    free(startVelocity);
+    free(startGround);
+    free(groundHit);
+    free(velocity);
+    free(ground);
+    free(checkVelocity);
+    free(checkGround);
+    return 0;
+}
@@ -0,0 +1,215 @@
+#include "bench_common.h"
+#include "snapshot.h"
+
+// cold start: building the world (meshes, colliders, SpawnActors and its ground raycasts) against LoadWorldSnapshot.
+// the game builds from glbs, which parse slower than GenGroundTile, so the build numbers here are a floor
+// run from the repo root: bin/Release/snapshot_bench
+
+#define BENCH_REPEATS 5
+#define BENCH_ACTORS 100000
+#define ACTOR_TYPES 4
+#define GROUND_TILES 4          // per side, each tile its own mesh and collider like the map's
+#define GROUND_QUADS 16         // per tile side
+#define GROUND_SIZE 16.0f
+#define BENCH_SNAPSHOT "snapshot_bench.snapshot"
+#define BENCH_STAMP 1
+
+ecs_entity_t prefabs[ACTOR_TYPES];
+Position spawnPositions[BENCH_ACTORS];
+
+// the prefabs, which exist before either kind of load
+// what main.c does without a snapshot: make the meshes, collide against them, drop the actors onto them
+Model BuildWorld(void) {
+    Model ground = { 0 };
+    ground.transform = MatrixIdentity();
+    ground.meshCount = GROUND_TILES * GROUND_TILES;
+    ground.meshes = RL_CALLOC(ground.meshCount, sizeof(Mesh));
+
+    float tileSize = GROUND_SIZE / GROUND_TILES;
+    for(int ty = 0; ty < GROUND_TILES; ty ++) {
+        for(int tx = 0; tx < GROUND_TILES; tx ++) {
+            Mesh * mesh = &ground.meshes[ty * GROUND_TILES + tx];
+            *mesh = GenGroundTile(-GROUND_SIZE / 2 + tx * tileSize, -GROUND_SIZE / 2 + ty * tileSize, tileSize, GROUND_QUADS, true);
+            UploadMesh(mesh, false);
+        }
+    }
+
+    Matrix identity = MatrixIdentity();
+    ecs_entity_t groundEntity = ecs_new(world);
+    ecs_set_ptr(world, groundEntity, Model, &ground);
+    ecs_set_ptr(world, groundEntity, Matrix, &identity);
+
+    MeshCollider * colliders = GetModelMeshCollidersArena(FrameArena(), ground, identity);
+    for(int i = 0; i < ground.meshCount; i ++) {
+        ecs_entity_t collider = ecs_new(world);
+        ecs_set_ptr(world, collider, MeshCollider, &colliders[i]);
+    }
+    FrameArenaReset();
+
+    int perType = BENCH_ACTORS / ACTOR_TYPES;
+    for(int t = 0; t < ACTOR_TYPES; t ++) {
+        SpawnActors(prefabs[t], t, &spawnPositions[t * perType], perType, NULL);
+    }
+
+    return ground;
+}
+
+// give the actors some state worth keeping, fresh spawns are all zero velocity
+void StirActors(void) {
+    ecs_query_t * q = ecs_query(world, { .terms = { { ecs_id(Velocity) }, { ecs_id(GroundState) } } });
+    ecs_iter_t it = ecs_query_iter(world, q);
+    int n = 0;
+    while(ecs_query_next(&it)) {
+        Velocity * velocity = ecs_field(&it, Velocity, 0);
+        GroundState * ground = ecs_field(&it, GroundState, 1);
+        for(int i = 0; i < it.count; i ++, n ++) {
+            velocity[i] = (Velocity){ sinf(n * 0.01f), cosf(n * 0.01f), -0.01f * (n % 5) };
+            ground[i].grounded = n % (ACTOR_GROUND_TIME + 1);
+        }
+    }
+    ecs_query_fini(q);
+}
+
+uint64_t HashBytes(uint64_t hash, const void * data, size_t size) {
+    const uint8_t * bytes = data;
+    for(size_t i = 0; i < size; i ++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// actors per prefab, collider bounds and what the colliders answer. the same world hashes the same however it was made
+uint64_t WorldHash(void) {
+    uint64_t hash = 14695981039346656037ull;
+
+    for(int p = 0; p < ACTOR_TYPES; p ++) {
+        ecs_query_t * q = ecs_query(world, {
+            .terms = {
+                { ecs_id(ActorType) }, { ecs_id(Position) }, { ecs_id(Velocity) }, { ecs_id(GroundState) },
+                { ecs_pair(EcsIsA, prefabs[p]) }
+            }
+        });
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while(ecs_query_next(&it)) {
+            hash = HashBytes(hash, ecs_field(&it, ActorType, 0), sizeof(ActorType) * it.count);
+            hash = HashBytes(hash, ecs_field(&it, Position, 1), sizeof(Position) * it.count);
+            hash = HashBytes(hash, ecs_field(&it, Velocity, 2), sizeof(Velocity) * it.count);
+            hash = HashBytes(hash, ecs_field(&it, GroundState, 3), sizeof(GroundState) * it.count);
+        }
+        ecs_query_fini(q);
+    }
+
+    ecs_iter_t it = ecs_query_iter(world, q_MeshCollider);
+    while(ecs_query_next(&it)) {
+        MeshCollider * colliders = ecs_field(&it, MeshCollider, 0);
+        for(int i = 0; i < it.count; i ++) {
+            hash = HashBytes(hash, &colliders[i].box, sizeof(BoundingBox));
+            hash = HashBytes(hash, &colliders[i].worldBox, sizeof(BoundingBox));
+            hash = HashBytes(hash, &colliders[i].transform, sizeof(Matrix));
+        }
+    }
+
+    for(int i = 0; i < 64; i ++) {
+        float z = GetElevation(-7.0f + (i % 8) * 2.0f, -7.0f + (i / 8) * 2.0f, 8.0f);
+        hash = HashBytes(hash, &z, sizeof(z));
+    }
+    return hash;
+}
+
+double TimeBuild(void) {
+    double start = BenchNanoseconds();
+    BenchWorld(prefabs, ACTOR_TYPES, true);
+    Model ground = BuildWorld();
+    double time = BenchNanoseconds() - start;
+
+    ecs_fini(world);
+    UnloadModel(ground);
+    FrameArenaReset();
+    return time;
+}
+
+double TimeLoad(void) {
+    WorldSnapshot snapshot;
+    double start = BenchNanoseconds();
+    BenchWorld(prefabs, ACTOR_TYPES, true);
+    bool ok = LoadWorldSnapshot(BENCH_SNAPSHOT, BENCH_STAMP, &snapshot, prefabs, ACTOR_TYPES);
+    double time = BenchNanoseconds() - start;
+
+    ecs_fini(world);
+    if(ok)
+        UnloadWorldSnapshot(&snapshot);
+    FrameArenaReset();
+    return ok ? time : -1.0;
+}
+
+int main(void) {
+    ecs_os_set_api_defaults();
+
+    // UploadMesh needs a context
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(64, 64, "snapshot_bench");
+
+    for(int i = 0; i < BENCH_ACTORS; i ++) {
+        spawnPositions[i] = (Position){ BenchRandom(-7.5f, 7.5f), BenchRandom(-7.5f, 7.5f), 8.0f };
+    }
+
+    // save a built world, load it into an empty one, both have to hash the same
+    BenchWorld(prefabs, ACTOR_TYPES, true);
+    Model ground = BuildWorld();
+    StirActors();
+    uint64_t built = WorldHash();
+    bool saved = SaveWorldSnapshot(BENCH_SNAPSHOT, BENCH_STAMP, NULL, prefabs, ACTOR_TYPES);
+    ecs_fini(world);
+    UnloadModel(ground);
+    FrameArenaReset();
+
+    if(!saved) {
+        printf("SaveWorldSnapshot failed\n");
+        return 1;
+    }
+
+    WorldSnapshot snapshot;
+    BenchWorld(prefabs, ACTOR_TYPES, true);
+    bool loaded = LoadWorldSnapshot(BENCH_SNAPSHOT, BENCH_STAMP, &snapshot, prefabs, ACTOR_TYPES);
+    uint64_t restored = loaded ? WorldHash() : 0;
+    ecs_fini(world);
+    if(loaded)
+        UnloadWorldSnapshot(&snapshot);
+
+    BenchWorld(prefabs, ACTOR_TYPES, true);
+    bool stale = LoadWorldSnapshot(BENCH_SNAPSHOT, BENCH_STAMP + 1, &snapshot, prefabs, ACTOR_TYPES);
+    ecs_fini(world);
+
+    if(!loaded || restored != built || stale) {
+        printf("snapshot round trip failed (loaded %d, hash %s, stale accepted %d)\n", loaded, restored == built ? "ok" : "differs", stale);
+        return 1;
+    }
+
+    double bestBuild = TimeBuild();
+    double bestLoad = TimeLoad();
+    for(int i = 1; i < BENCH_REPEATS; i ++) {
+        double t = TimeBuild();
+        if(t < bestBuild)
+            bestBuild = t;
+        t = TimeLoad();
+        if(t < bestLoad)
+            bestLoad = t;
+    }
+
+    FILE * file = fopen(BENCH_SNAPSHOT, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+
+    // the file was just written, so it's in the page cache. a true cold start adds the disk read to both
+    printf("world: %d actors, %d ground meshes, snapshot %.1f KB\n", BENCH_ACTORS, GROUND_TILES * GROUND_TILES, size / 1024.0);
+    printf("%-16s %12s\n", "start", "ms");
+    printf("%-16s %12.2f\n", "build", bestBuild / 1e6);
+    printf("%-16s %12.2f\n", "snapshot", bestLoad / 1e6);
+    printf("speedup %.2fx\n", bestBuild / bestLoad);
+
+    remove(BENCH_SNAPSHOT);
+    CloseWindow();
+    return 0;
+}
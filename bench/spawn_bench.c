@@ -0,0 +1,134 @@
+#include "bench_common.h"
+
+// actor spawning: the old one at a time path (ecs_new_w_pair then an ecs_set per component) against SpawnActors
+// run from the repo root: bin/Release/spawn_bench
+
+#define BENCH_REPEATS 5
+#define SPAWN_COUNT 100000
+#define SPAWN_TYPES 4
+#define GROUND_TILES 4          // per side, each tile its own collider like the map's meshes
+#define GROUND_QUADS 4          // per tile side
+#define GROUND_SIZE 16.0f
+
+Mesh groundMeshes[GROUND_TILES * GROUND_TILES];
+
+ecs_entity_t prefabs[SPAWN_TYPES];
+
+void SpawnWorld(void) {
+    BenchWorld(prefabs, SPAWN_TYPES, true);
+
+    for(int i = 0; i < GROUND_TILES * GROUND_TILES; i ++) {
+        MeshCollider collider = MakeMeshCollider(&groundMeshes[i], MatrixIdentity());
+        ecs_entity_t e = ecs_new(world);
+        ecs_set_ptr(world, e, MeshCollider, &collider);
+    }
+}
+
+// what main.c used to do per actor
+double SpawnOneAtATime(const Position * positions, const int * types) {
+    SpawnWorld();
+    double start = BenchNanoseconds();
+    for(int i = 0; i < SPAWN_COUNT; i ++) {
+        ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, prefabs[types[i]]);
+        ecs_set(world, inst, CamDistance, { 0 });
+        ecs_set(world, inst, ActorType, { types[i] });
+        ecs_set(world, inst, Velocity, { 0 });
+        ecs_set(world, inst, GroundState, { .groundNormal = up });
+        ecs_set(world, inst, ContactManifold, { 0 });
+        float z = GetElevation(positions[i].x, positions[i].y, positions[i].z);
+        if(z == FLT_MAX)
+            z = 0.0f;
+
+        ecs_set(world, inst, Position, { positions[i].x, positions[i].y, z });
+    }
+    double time = BenchNanoseconds() - start;
+    ecs_fini(world);
+    return time;
+}
+
+// positions come grouped by type, same as main.c hands them to SpawnActors
+double SpawnBulk(const Position * positions, const int * typeCounts) {
+    SpawnWorld();
+    double start = BenchNanoseconds();
+    int offset = 0;
+    for(int t = 0; t < SPAWN_TYPES; t ++) {
+        SpawnActors(prefabs[t], t, &positions[offset], typeCounts[t], NULL);
+        offset += typeCounts[t];
+    }
+    double time = BenchNanoseconds() - start;
+    ecs_fini(world);
+    return time;
+}
+
+// both paths have to leave the same actors behind
+bool CheckSpawn(const Position * positions, int count) {
+    SpawnWorld();
+    SpawnActors(prefabs[0], 0, positions, count, NULL);
+
+    ecs_query_t * q = ecs_query(world, {
+        .terms = { { ecs_id(ActorType) }, { ecs_id(Position) }, { ecs_id(BenchSprite) }, { ecs_id(ActorShape) } }
+    });
+
+    bool ok = true;
+    int found = 0;
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while(ecs_query_next(&it)) {
+        Position * p = ecs_field(&it, Position, 1);
+        for(int i = 0; i < it.count; i ++, found ++) {
+            float z = GetElevation(p[i].x, p[i].y, 8.0f);
+            if(fabsf(p[i].z - (z == FLT_MAX ? 0.0f : z)) > 1e-4f)
+                ok = false;
+        }
+    }
+    ecs_query_fini(q);
+    ecs_fini(world);
+
+    return ok && found == count;
+}
+
+int main(void) {
+    ecs_os_set_api_defaults();
+
+    float tileSize = GROUND_SIZE / GROUND_TILES;
+    for(int ty = 0; ty < GROUND_TILES; ty ++) {
+        for(int tx = 0; tx < GROUND_TILES; tx ++) {
+            groundMeshes[ty * GROUND_TILES + tx] = GenGroundTile(-GROUND_SIZE / 2 + tx * tileSize, -GROUND_SIZE / 2 + ty * tileSize, tileSize, GROUND_QUADS, false);
+        }
+    }
+
+    int * types = malloc(sizeof(int) * SPAWN_COUNT);
+    Position * positions = malloc(sizeof(Position) * SPAWN_COUNT);
+    int typeCounts[SPAWN_TYPES] = { 0 };
+
+    // sorted by type so the same positions feed both paths
+    for(int i = 0; i < SPAWN_COUNT; i ++) {
+        types[i] = i * SPAWN_TYPES / SPAWN_COUNT;
+        typeCounts[types[i]] ++;
+        positions[i] = (Position){ BenchRandom(-7.5f, 7.5f), BenchRandom(-7.5f, 7.5f), 8.0f };
+    }
+
+    if(!CheckSpawn(positions, 10000)) {
+        printf("SpawnActors placed actors wrong\n");
+        return 1;
+    }
+
+    double bestOld = SpawnOneAtATime(positions, types);
+    double bestNew = SpawnBulk(positions, typeCounts);
+    for(int i = 1; i < BENCH_REPEATS; i ++) {
+        double t = SpawnOneAtATime(positions, types);
+        if(t < bestOld)
+            bestOld = t;
+        t = SpawnBulk(positions, typeCounts);
+        if(t < bestNew)
+            bestNew = t;
+    }
+
+    printf("%-16s %12s %14s\n", "spawn 100k", "ms", "actors/sec");
+    printf("%-16s %12.2f %14.0f\n", "one at a time", bestOld / 1e6, SPAWN_COUNT / (bestOld / 1e9));
+    printf("%-16s %12.2f %14.0f\n", "SpawnActors", bestNew / 1e6, SPAWN_COUNT / (bestNew / 1e9));
+    printf("speedup %.2fx\n", bestOld / bestNew);
+
+    free(types);
+    free(positions);
+    return 0;
+}
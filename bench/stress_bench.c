@@ -0,0 +1,611 @@
+#include "bench_common.h"
+#include "assets.h"
+#include "inspect.h"
+#include "collisionstats.h"
+#include "replay.h"
+
+// headless load test: actors spawned on map1.glb, ActorPhysics ticked as fast as it goes, with the
+// input read from a script instead of the keyboard. per tick it reports where the time went, the ground
+// test, the velocity pass, the move and the mouse picks, so the collider loops show up as the count grows.
+// with USE_COLLISION_COUNTERS it also reports the box checks per tick, the share of them that skipped
+// the narrowphase and GJK's iterations per run, to compare from one release to the next
+// run from the repo root: bin/Release/stress_bench [options]
+//   --actors N       actor count, default 1000
+//   --sweep          1, 10, 100 ... up to --actors (default 100000 here) instead of one count
+//   --seconds S      how long to run each count, default 2
+//   --ticks T        stop after T ticks instead, whichever comes first when both are given
+//   --picks P        mouse ray picks per tick, default 1 like the game
+//   --script FILE    input script, see below. without one the actors walk in a circle and jump every 120 ticks
+//   --rest [PORT]    serve each world to the flecs explorer on 127.0.0.1 while it runs
+//   --replay FILE    play back a recording from the game's --record instead: its actors, its input and its mouse
+//                    picks, once through unless --ticks or --seconds cut it short
+//   --checksum       with --replay, check the actors against the recording's checksums after every tick. the
+//                    hashing shows up under other
+//   --golden FILE    hash every actor after every tick into FILE, for a fixed number of ticks (--ticks, default 600,
+//                    or the replay's length)
+//   --verify FILE    run the scenario FILE was made from again and stop at the first tick whose actors hash
+//                    differently, saying which actor. exits 1 when they don't match. make the golden file before
+//                    touching collision.c or ActorPhysics, verify after
+//
+// a script is lines of "tick move.x move.y [jump]", each held from its tick until the next line.
+// jump fires on the line's first tick only, # starts a comment, and the script loops from its last line's tick
+
+#define STRESS_DEFAULT_ACTORS 1000
+#define STRESS_SWEEP_MAX 100000
+#define STRESS_MIN_TICKS 3          // even when a tick takes longer than --seconds
+#define STRESS_MAX_STEPS 256
+#define STRESS_TYPES (ACTOR_PURPLE + 1)
+#define STRESS_SPAWN_RANGE 7.5f     // same square main spawns in
+#define STRESS_GOLDEN_TICKS 600
+
+#define GOLDEN_MAGIC 0x444c4f47     // "GOLD"
+#define GOLDEN_VERSION 2
+
+typedef struct InputStep {
+    int tick;
+    Vector2 move;
+    bool jump;
+} InputStep;
+
+typedef struct InputScript {
+    InputStep steps[STRESS_MAX_STEPS];
+    int count;
+    int length;                 // ticks before it loops
+} InputScript;
+
+// what the scenario was, then per tick ActorChecksum and ActorHashes for every actor
+typedef struct GoldenHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t actors;
+    int32_t ticks;
+    int32_t picks;
+    int32_t pad;
+    uint64_t inputHash;         // StressInputHash over the ticks
+} GoldenHeader;
+
+typedef struct Golden {
+    GoldenHeader header;
+    uint8_t * data;             // the whole file
+} Golden;
+
+typedef struct StressOptions {
+    const InputScript * script;
+    double seconds;
+    int maxTicks;
+    int picks;
+    int restPort;
+    const Replay * replay;      // NULL to spawn and follow the script
+    bool checksum;
+    FILE * goldenOut;           // --golden, header already written
+    const Golden * golden;      // --verify
+} StressOptions;
+
+typedef struct StressResult {
+    int actors;
+    int ticks;
+    double seconds;
+    double ground;              // ns, all ticks
+    double integrate;
+    double move;
+    double picks;
+    double other;
+    CollisionFrameStats collision;  // all ticks
+    int checked;                // ticks checksummed against the replay
+    int mismatched;
+    int firstMismatch;          // tick, -1 for none
+    int divergedTick;           // first tick that didn't match --verify's file, -1 for none
+    char diverged[256];
+} StressResult;
+
+bool LoadInputScript(const char * path, InputScript * script) {
+    FILE * file = fopen(path, "r");
+    if(file == NULL)
+        return false;
+
+    script->count = 0;
+    char line[256];
+    int lineNumber = 0;
+    bool ok = true;
+    while(fgets(line, sizeof(line), file) != NULL) {
+        lineNumber ++;
+        char * comment = strchr(line, '#');
+        if(comment != NULL)
+            *comment = '\0';
+
+        InputStep step = { 0 };
+        char jump[16] = { 0 };
+        int read = sscanf(line, "%d %f %f %15s", &step.tick, &step.move.x, &step.move.y, jump);
+        if(read <= 0)
+            continue;
+        if(read < 3 || (read == 4 && strcmp(jump, "jump") != 0) || (script->count > 0 && step.tick <= script->steps[script->count - 1].tick)) {
+            printf("%s:%d: expected \"tick move.x move.y [jump]\" with ticks increasing\n", path, lineNumber);
+            ok = false;
+            break;
+        }
+        if(script->count == STRESS_MAX_STEPS) {
+            printf("%s: more than %d lines\n", path, STRESS_MAX_STEPS);
+            ok = false;
+            break;
+        }
+        step.jump = read == 4;
+        step.move = Vector2Normalize(step.move);
+        script->steps[script->count ++] = step;
+    }
+    fclose(file);
+
+    if(ok && script->count == 0) {
+        printf("%s: empty script\n", path);
+        ok = false;
+    }
+    script->length = ok ? script->steps[script->count - 1].tick + 1 : 0;
+    return ok;
+}
+
+// a circle, a step every 10 ticks, and a jump every 120
+void DefaultInputScript(InputScript * script) {
+    script->count = 0;
+    for(int t = 0; t < 120; t += 10) {
+        float angle = t * (2.0f * PI / 120.0f);
+        script->steps[script->count ++] = (InputStep){ t, { cosf(angle), sinf(angle) }, t == 0 };
+    }
+    script->length = 120;
+}
+
+InputStep ScriptInput(const InputScript * script, int tick) {
+    int t = tick % script->length;
+    int i = 0;
+    while(i + 1 < script->count && script->steps[i + 1].tick <= t) {
+        i ++;
+    }
+    InputStep step = script->steps[i];
+    step.jump = step.jump && step.tick == t;
+    return step;
+}
+
+void StressWorld(const AssetModel * map, ecs_entity_t * prefabs) {
+    BenchWorld(prefabs, STRESS_TYPES, false);
+    ECS_COLLIDER_SYSTEMS();
+
+    MeshCollider * colliders = GetAssetMeshCollidersArena(FrameArena(), map, MatrixIdentity());
+    for(int i = 0; i < map->model.meshCount; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set_ptr(world, e, MeshCollider, &colliders[i]);
+    }
+    FrameArenaReset();
+}
+
+// the input the run will be given, so a golden file isn't checked against a different scenario
+uint64_t StressInputHash(const StressOptions * options, int ticks) {
+    uint64_t h = CHECKSUM_BASIS;
+    for(int t = 0; t < ticks; t ++) {
+        int32_t jump;
+        if(options->replay != NULL) {
+            const ReplayTick * tick = &options->replay->ticks[t];
+            h = ChecksumWords(h, &tick->move, sizeof(Vector2));
+            h = ChecksumWords(h, &tick->pick, sizeof(Ray));
+            jump = tick->jump;
+        }
+        else {
+            InputStep step = ScriptInput(options->script, t);
+            h = ChecksumWords(h, &step.move, sizeof(Vector2));
+            jump = step.jump;
+        }
+        h = ChecksumWords(h, &jump, sizeof(jump));
+    }
+    return h;
+}
+
+size_t GoldenTickSize(const GoldenHeader * header) {
+    return sizeof(uint64_t) + sizeof(uint32_t) * (size_t)header->actors;
+}
+
+bool LoadGolden(const char * path, Golden * golden) {
+    *golden = (Golden){ 0 };
+    FILE * file = fopen(path, "rb");
+    if(file == NULL)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    golden->data = malloc(size > 0 ? size : 1);
+    bool ok = size >= (long)sizeof(GoldenHeader) && fread(golden->data, 1, size, file) == (size_t)size;
+    fclose(file);
+
+    if(ok) {
+        memcpy(&golden->header, golden->data, sizeof(GoldenHeader));
+        ok = golden->header.magic == GOLDEN_MAGIC && golden->header.version == GOLDEN_VERSION && golden->header.actors >= 0 &&
+            golden->header.ticks > 0 && (size_t)size == sizeof(GoldenHeader) + GoldenTickSize(&golden->header) * golden->header.ticks;
+    }
+    if(!ok) {
+        printf("%s isn't a whole version %d golden file\n", path, GOLDEN_VERSION);
+        free(golden->data);
+        *golden = (Golden){ 0 };
+    }
+    return ok;
+}
+
+void WriteGoldenTick(FILE * file, ecs_query_t * q, uint32_t * hashes, int actors) {
+    uint64_t sum = ActorChecksum(q);
+    ActorHashes(q, hashes, NULL, actors);
+    fwrite(&sum, sizeof(sum), 1, file);
+    fwrite(hashes, sizeof(uint32_t), actors, file);
+}
+
+// false, with what went wrong in result->diverged, when the actors don't hash like the golden file's
+bool VerifyTick(const Golden * golden, int tick, ecs_query_t * q, uint32_t * hashes, ecs_entity_t * entities, StressResult * result) {
+    const uint8_t * record = golden->data + sizeof(GoldenHeader) + GoldenTickSize(&golden->header) * tick;
+    uint64_t expected;
+    memcpy(&expected, record, sizeof(expected));
+    if(ActorChecksum(q) == expected)
+        return true;
+
+    // only now per actor, to find which
+    result->divergedTick = tick;
+    int count = ActorHashes(q, hashes, entities, golden->header.actors);
+    if(count != golden->header.actors) {
+        snprintf(result->diverged, sizeof(result->diverged), "tick %d: %d actors, the golden file has %d", tick, count, golden->header.actors);
+        return false;
+    }
+
+    const uint32_t * expectedHashes = (const uint32_t *)(record + sizeof(uint64_t));
+    int first = -1;
+    int differing = 0;
+    for(int i = 0; i < count; i ++) {
+        if(hashes[i] != expectedHashes[i]) {
+            if(first < 0)
+                first = i;
+            differing ++;
+        }
+    }
+    if(first < 0) {
+        snprintf(result->diverged, sizeof(result->diverged), "tick %d: every actor matches but the sum doesn't, a hash collided", tick);
+        return false;
+    }
+
+    ecs_entity_t e = entities[first];
+    const ActorType * type = ecs_get(world, e, ActorType);
+    const Position * p = ecs_get(world, e, Position);
+    const Velocity * v = ecs_get(world, e, Velocity);
+    const GroundState * g = ecs_get(world, e, GroundState);
+    snprintf(result->diverged, sizeof(result->diverged),
+        "tick %d: %d of %d actors differ, first actor %d, entity %u (type %d) at (%.6f %.6f %.6f) moving (%.6f %.6f %.6f) grounded %d",
+        tick, differing, count, first, (uint32_t)e, type->type, p->x, p->y, p->z, v->x, v->y, v->z, g->grounded);
+    return false;
+}
+
+StressResult RunStress(const AssetModel * map, int actors, const StressOptions * options) {
+    StressResult result = { .actors = actors, .firstMismatch = -1, .divergedTick = -1 };
+    const Replay * replay = options->replay;
+    double seconds = options->seconds;
+    int maxTicks = options->maxTicks;
+    int picks = options->picks;
+    ecs_entity_t prefabs[STRESS_TYPES];
+    StressWorld(map, prefabs);
+    if(options->restPort > 0) {
+        StartInspect((uint16_t)options->restPort);
+#if USE_COLLISION_COUNTERS
+        RegisterCollisionMetrics();
+#endif
+    }
+
+    if(replay != NULL) {
+        // the game's prefabs are one per actor type too
+        InsertReplayActors(replay, prefabs, STRESS_TYPES);
+        FrameArenaReset();
+        result.actors = replay->actorCount;
+        if(maxTicks <= 0 || maxTicks > replay->header.tickCount)
+            maxTicks = replay->header.tickCount;
+        picks = 1;
+    }
+    else {
+        // one bulk spawn per type like main, dropped onto the map from above
+        srand(1);
+        Position * positions = malloc(sizeof(Position) * actors);
+        for(int type = 0; type < STRESS_TYPES; type ++) {
+            int first = actors * type / STRESS_TYPES;
+            int count = actors * (type + 1) / STRESS_TYPES - first;
+            for(int i = 0; i < count; i ++) {
+                positions[i] = (Position){ BenchRandom(-STRESS_SPAWN_RANGE, STRESS_SPAWN_RANGE), BenchRandom(-STRESS_SPAWN_RANGE, STRESS_SPAWN_RANGE), 8.0f };
+            }
+            SpawnActors(prefabs[type], type, positions, count, NULL);
+            FrameArenaReset();
+        }
+        free(positions);
+    }
+
+    ecs_query_t * q_actors = ecs_query(world, {
+        .terms = {
+            { ecs_id(Position) }, { ecs_id(Velocity) }, { ecs_id(GroundState) }, { ecs_id(ContactManifold) },
+            { ecs_id(ActorShape), .inout = EcsIn }
+        }
+    });
+    // per actor hashes for --golden and --verify
+    uint32_t * hashes = NULL;
+    ecs_entity_t * entities = NULL;
+    if(options->goldenOut != NULL || options->golden != NULL) {
+        hashes = malloc(sizeof(uint32_t) * (result.actors > 0 ? result.actors : 1));
+        entities = malloc(sizeof(ecs_entity_t) * (result.actors > 0 ? result.actors : 1));
+    }
+    ecs_query_t * q_checksum = options->checksum || hashes != NULL ? ActorChecksumQuery() : NULL;
+
+    actorPhaseTimes = (ActorPhaseTimes){ 0 };
+    CollisionCounters countersBefore = SumCollisionCounters();
+    double start = BenchNanoseconds();
+    double elapsed = 0;
+    while(true) {
+        if((maxTicks > 0 || replay != NULL) && result.ticks >= maxTicks)
+            break;
+        if((seconds > 0 || maxTicks <= 0) && result.ticks >= STRESS_MIN_TICKS && elapsed >= seconds * 1e9)
+            break;
+
+        // 0 has flecs time the ticks itself, so its stats are in real seconds
+        const ReplayTick * recorded = replay != NULL ? &replay->ticks[result.ticks] : NULL;
+        InputStep input = recorded != NULL ? (InputStep){ result.ticks, recorded->move, recorded->jump } : ScriptInput(options->script, result.ticks);
+#if USE_COLLISION_COUNTERS
+        if(options->restPort > 0)
+            UpdateCollisionStats();
+#endif
+        ecs_progress(world, 0);
+        UpdateInspect(ecs_get_world_info(world)->delta_time);
+
+        // the game picks once a frame under the mouse, here the mouse wanders over the map
+        double pickStart = BenchNanoseconds();
+        for(int p = 0; p < picks; p ++) {
+            float angle = (result.ticks * picks + p) * 0.37f;
+            Ray ray = { { 6.0f * cosf(angle), 6.0f * sinf(angle), 20.0f }, down };
+            RayToAnyCollider(recorded != NULL ? recorded->pick : ray, FLT_MAX);
+        }
+        result.picks += BenchNanoseconds() - pickStart;
+
+        ecs_iter_t it = ecs_query_iter(world, q_actors);
+        while(ecs_query_next(&it)) {
+            ActorPhysics(&it, input.move, input.jump);
+        }
+
+        if(q_checksum != NULL && recorded != NULL && recorded->checked) {
+            result.checked ++;
+            if(ActorChecksum(q_checksum) != recorded->checksum) {
+                if(result.mismatched ++ == 0)
+                    result.firstMismatch = result.ticks;
+            }
+        }
+        if(options->goldenOut != NULL)
+            WriteGoldenTick(options->goldenOut, q_checksum, hashes, result.actors);
+        bool diverged = options->golden != NULL && !VerifyTick(options->golden, result.ticks, q_checksum, hashes, entities, &result);
+
+        FrameArenaReset();
+        result.ticks ++;
+        elapsed = BenchNanoseconds() - start;
+        // every tick after it would differ too
+        if(diverged)
+            break;
+    }
+
+    result.seconds = elapsed / 1e9;
+    result.ground = actorPhaseTimes.ground;
+    result.integrate = actorPhaseTimes.integrate;
+    result.move = actorPhaseTimes.move;
+    result.other = elapsed - result.ground - result.integrate - result.move - result.picks;
+    CollisionCounters countersAfter = SumCollisionCounters();
+    result.collision = CollisionFrameStatsBetween(&countersBefore, &countersAfter);
+
+    ecs_query_fini(q_actors);
+    if(q_checksum != NULL)
+        ecs_query_fini(q_checksum);
+    free(hashes);
+    free(entities);
+    ecs_fini(world);
+    return result;
+}
+
+void PrintHeader(void) {
+    printf("%8s %7s %10s %10s %10s %10s %10s %10s %10s %12s", "actors", "ticks", "ticks/sec", "ms/tick",
+        "ground", "integrate", "move", "picks", "other", "us/actor");
+#if USE_COLLISION_COUNTERS
+    printf(" %12s %8s %9s", "boxes/tick", "culled", "gjk it/run");
+#endif
+    printf("\n");
+}
+
+// phases in ms per tick
+void PrintResult(const StressResult * r) {
+    double perTick = 1e6 * r->ticks;
+    double tick = r->seconds * 1e3 / r->ticks;
+    printf("%8d %7d %10.1f %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %12.3f", r->actors, r->ticks, r->ticks / r->seconds, tick,
+        r->ground / perTick, r->integrate / perTick, r->move / perTick, r->picks / perTick, r->other / perTick,
+        (r->ground + r->integrate + r->move) / 1e3 / ((double)r->ticks * r->actors));
+#if USE_COLLISION_COUNTERS
+    printf(" %12.0f %7.1f%% %9.2f", r->collision.aabb_tests / r->ticks, 100.0 * r->collision.cull_ratio, r->collision.gjk_iterations_per_call);
+#endif
+    printf("\n");
+}
+
+int main(int argc, char ** argv) {
+    ecs_os_set_api_defaults();
+
+    int actors = 0;
+    bool sweep = false;
+    double seconds = 2.0;
+    int maxTicks = 0;
+    int picks = 1;
+    const char * scriptPath = NULL;
+    bool secondsGiven = false;
+    int restPort = 0;
+    const char * replayPath = NULL;
+    bool checksum = false;
+    const char * goldenPath = NULL;
+    const char * verifyPath = NULL;
+
+    for(int i = 1; i < argc; i ++) {
+        bool hasValue = i + 1 < argc;
+        if(strcmp(argv[i], "--actors") == 0 && hasValue)
+            actors = atoi(argv[++ i]);
+        else if(strcmp(argv[i], "--sweep") == 0)
+            sweep = true;
+        else if(strcmp(argv[i], "--seconds") == 0 && hasValue) {
+            seconds = atof(argv[++ i]);
+            secondsGiven = true;
+        }
+        else if(strcmp(argv[i], "--ticks") == 0 && hasValue)
+            maxTicks = atoi(argv[++ i]);
+        else if(strcmp(argv[i], "--picks") == 0 && hasValue)
+            picks = atoi(argv[++ i]);
+        else if(strcmp(argv[i], "--script") == 0 && hasValue)
+            scriptPath = argv[++ i];
+        else if(strcmp(argv[i], "--rest") == 0) {
+            restPort = INSPECT_DEFAULT_PORT;
+            if(hasValue && atoi(argv[i + 1]) > 0)
+                restPort = atoi(argv[++ i]);
+        }
+        else if(strcmp(argv[i], "--replay") == 0 && hasValue)
+            replayPath = argv[++ i];
+        else if(strcmp(argv[i], "--checksum") == 0)
+            checksum = true;
+        else if(strcmp(argv[i], "--golden") == 0 && hasValue)
+            goldenPath = argv[++ i];
+        else if(strcmp(argv[i], "--verify") == 0 && hasValue)
+            verifyPath = argv[++ i];
+        else {
+            printf("usage: stress_bench [--actors N] [--sweep] [--seconds S] [--ticks T] [--picks P] [--script FILE] [--rest [PORT]]\n"
+                "       stress_bench --replay FILE [--checksum] [--ticks T] [--seconds S] [--rest [PORT]]\n"
+                "       stress_bench --golden FILE | --verify FILE, with the scenario's options\n");
+            return 1;
+        }
+    }
+    if(replayPath != NULL && (sweep || scriptPath != NULL)) {
+        printf("--replay brings its own actors and input, it doesn't go with --sweep or --script\n");
+        return 1;
+    }
+    if((goldenPath != NULL || verifyPath != NULL) && (sweep || (goldenPath != NULL && verifyPath != NULL))) {
+        printf("--golden and --verify are one run each, not with --sweep or each other\n");
+        return 1;
+    }
+    if(actors <= 0)
+        actors = sweep ? STRESS_SWEEP_MAX : STRESS_DEFAULT_ACTORS;
+    // --ticks alone runs exactly that many, a replay runs its length
+    if((maxTicks > 0 || replayPath != NULL) && !secondsGiven)
+        seconds = 0;
+
+    // read before the working directory moves to resources/
+    InputScript script;
+    if(scriptPath != NULL) {
+        if(!LoadInputScript(scriptPath, &script))
+            return 1;
+    }
+    else {
+        DefaultInputScript(&script);
+    }
+    Replay replay = { 0 };
+    if(replayPath != NULL) {
+        if(!LoadReplay(replayPath, &replay))
+            return 1;
+        if(replay.header.tickCount == 0) {
+            printf("%s: no ticks recorded\n", replayPath);
+            return 1;
+        }
+    }
+
+    // a golden file is a fixed number of ticks, and verifying runs the same actors, ticks and picks again
+    Golden golden = { 0 };
+    if(verifyPath != NULL) {
+        if(!LoadGolden(verifyPath, &golden))
+            return 1;
+        actors = golden.header.actors;
+        maxTicks = golden.header.ticks;
+        picks = golden.header.picks;
+    }
+    else if(goldenPath != NULL && maxTicks <= 0) {
+        maxTicks = replayPath != NULL ? replay.header.tickCount : STRESS_GOLDEN_TICKS;
+    }
+    if(goldenPath != NULL || verifyPath != NULL) {
+        seconds = 0;
+        if(replayPath != NULL) {
+            actors = replay.actorCount;
+            if(maxTicks > replay.header.tickCount) {
+                printf("%s has %d ticks, %d needed\n", replayPath, replay.header.tickCount, maxTicks);
+                return 1;
+            }
+        }
+        if(verifyPath != NULL && actors != golden.header.actors) {
+            printf("%s was made with %d actors, the replay has %d\n", verifyPath, golden.header.actors, actors);
+            return 1;
+        }
+    }
+
+    StressOptions options = { &script, seconds, maxTicks, picks, restPort, replayPath != NULL ? &replay : NULL, checksum };
+    if(verifyPath != NULL) {
+        if(StressInputHash(&options, maxTicks) != golden.header.inputHash) {
+            printf("%s was made with different input, give it the same --script or --replay\n", verifyPath);
+            return 1;
+        }
+        options.golden = &golden;
+    }
+    if(goldenPath != NULL) {
+        options.goldenOut = fopen(goldenPath, "wb");
+        if(options.goldenOut == NULL) {
+            printf("couldn't write %s\n", goldenPath);
+            return 1;
+        }
+        GoldenHeader header = { GOLDEN_MAGIC, GOLDEN_VERSION, actors, maxTicks, picks, 0, StressInputHash(&options, maxTicks) };
+        fwrite(&header, sizeof(header), 1, options.goldenOut);
+    }
+
+    // the map's meshes upload on load, so they need a context
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(64, 64, "stress_bench");
+    if(!SearchAndSetResourceDir("resources")) {
+        printf("run from the repo root, resources/ not found\n");
+        return 1;
+    }
+
+    AssetModel map = LoadAssetModel("map1.glb");
+    if(map.model.meshCount == 0) {
+        printf("couldn't load map1.glb\n");
+        return 1;
+    }
+    if(replayPath != NULL) {
+        printf("replaying %s: %d actors, %d ticks, seed %u\n", replayPath, replay.actorCount, replay.header.tickCount, replay.header.seed);
+        if(replay.header.mapStamp != GetFileModTime("map1.glb"))
+            printf("map1.glb has changed since the recording, the actors won't follow it\n");
+    }
+
+    printf("phases in ms per tick, us/actor is ground + integrate + move\n");
+    PrintHeader();
+    bool matched = true;
+    if(sweep) {
+        for(int n = 1; n <= actors; n *= 10) {
+            StressResult r = RunStress(&map, n, &options);
+            PrintResult(&r);
+            fflush(stdout);
+        }
+    }
+    else {
+        StressResult r = RunStress(&map, actors, &options);
+        PrintResult(&r);
+        if(checksum && r.checked == 0)
+            printf("no checksums to check, --checksum needs a --replay with them\n");
+        else if(r.mismatched > 0)
+            printf("checksums: %d of %d ticks differ from the recording, first at tick %d\n", r.mismatched, r.checked, r.firstMismatch);
+        else if(checksum)
+            printf("checksums: all %d ticks match the recording\n", r.checked);
+
+        if(goldenPath != NULL) {
+            fclose(options.goldenOut);
+            printf("golden: %d ticks of %d actors hashed into %s\n", r.ticks, r.actors, goldenPath);
+        }
+        if(verifyPath != NULL && r.divergedTick >= 0)
+            printf("verify: differs from %s at %s\n", verifyPath, r.diverged);
+        else if(verifyPath != NULL)
+            printf("verify: all %d ticks match %s\n", r.ticks, verifyPath);
+        matched = r.mismatched == 0 && r.divergedTick < 0;
+    }
+
+    free(golden.data);
+    UnloadReplay(&replay);
+    UnloadAssetModel(&map);
+    CloseWindow();
+    return matched ? 0 : 1;
+}
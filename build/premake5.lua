@@ -28,6 +28,24 @@ newoption
     default = "glfw"
 }
 
+newoption
+{
+    trigger = "pgo",
+    value = "STAGE",
+    description = "which half of the PGO configuration to build, see the workspace below",
+    allowed = {
+        { "generate", "instrumented, a run writes profiles to build/pgo"},
+        { "use", "optimized with the profiles in build/pgo"},
+    },
+    default = "generate"
+}
+
+newoption
+{
+    trigger = "native",
+    description = "optimized configurations target this machine's cpu (-march=native), the binaries may not run anywhere else"
+}
+
 function download_progress(total, current)
     local ratio = current / total;
     ratio = math.min(math.max(ratio, 0), 1);
@@ -106,6 +124,58 @@ function platform_defines()
     filter{}
 end
 
+-- include dirs and links shared by the game and the tools built from its sources
+function game_settings()
+        includedirs { "../src" }
+        includedirs { "../include" }
+
+        links {"raylib", "ccd"} -- added ccd link for 3D collision detection
+
+        cdialect "C17"
+        cppdialect "C++17"
+
+        includedirs {raylib_dir .. "/src" }
+        includedirs {raylib_dir .."/src/external" }
+        includedirs { raylib_dir .."/src/external/glfw/include" }
+        flags { "ShadowedVariables"}
+        platform_defines()
+        defines { "FLECS_PERF_TRACE" } -- systems show up as profiler.c zones
+
+        filter "action:vs*"
+            defines{"_WINSOCK_DEPRECATED_NO_WARNINGS", "_CRT_SECURE_NO_WARNINGS"}
+            dependson {"raylib"}
+            links {"raylib.lib"}
+            characterset ("Unicode")
+            buildoptions { "/Zc:__cplusplus" }
+
+        filter "system:windows"
+            defines{"_WIN32"}
+            links {"winmm", "gdi32", "opengl32"}
+            libdirs {"../bin/%{cfg.buildcfg}"}
+
+        filter "system:linux"
+            links {"pthread", "m", "dl", "rt", "X11" }
+
+        filter "system:macosx"
+            links {"OpenGL.framework", "Cocoa.framework", "IOKit.framework", "CoreFoundation.framework", "CoreAudio.framework", "CoreVideo.framework", "AudioToolbox.framework" }
+
+        filter{}
+end
+
+-- console tool built from the game sources, with its own main() in place of src/main.c
+function tool_project(name, sources)
+    project (name)
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        files {"../src/**.c", "../src/**.h", "../include/**.h" }
+        removefiles {"../src/main.c"}
+        files (sources)
+
+        game_settings()
+end
+
 -- if you don't want to download raylib, then set this to false, and set the raylib dir to where you want raylib to be pulled from, must be full sources.
 downloadRaylib = true
 raylib_dir = "external/raylib-master"
@@ -125,9 +195,13 @@ if (os.isdir('external') == false) then
     os.mkdir('external')
 end
 
+-- where the PGO configuration's training run leaves its profiles, and where its objects go
+pgo_dir = path.getabsolute("pgo")
+pgo_objdir = path.getabsolute("build_files/obj")
+
 workspace (workspaceName)
     location "../"
-    configurations { "Debug", "Release"}
+    configurations { "Debug", "Release", "Release-LTO", "PGO" }
     platforms { "x64", "x86", "ARM64"}
 
     defaultplatform ("x64")
@@ -136,13 +210,45 @@ workspace (workspaceName)
         defines { "DEBUG" }
         symbols "On"
 
-    filter "configurations:Release"
+    filter "configurations:not Debug"
         defines { "NDEBUG" }
         optimize "On"
 
     filter {"configurations:Release", "action:vs*"}
        linktimeoptimization "On"
 
+    -- flecs.c, raylib and our physics as one program, so the hot loops can inline across them.
+    -- libccd is a prebuilt library and stays out of it
+    filter "configurations:Release-LTO or PGO"
+        linktimeoptimization "On"
+
+    -- PGO is built twice (gcc only):
+    --   in build/: ./premake5 gmake --pgo=generate, then from the root: make config=pgo_x64 clean && make config=pgo_x64
+    --   train from the root: rm -rf build/pgo && bin/PGO/stress_bench --sweep --seconds 1
+    --   in build/: ./premake5 gmake --pgo=use, then from the root: make config=pgo_x64 clean && make config=pgo_x64
+    -- the profiles are named by source file, not by project, so the game and the other tools are
+    -- optimized with what the stress_bench run saw too
+    filter "configurations:PGO"
+        objdir (pgo_objdir .. "/%{cfg.platform}/PGO/%{prj.name}")
+
+    filter {"configurations:PGO", "toolset:gcc"}
+        buildoptions { "-fprofile-prefix-path=" .. pgo_objdir .. "/%{cfg.platform}/PGO/%{prj.name}" }
+
+    filter {"configurations:PGO", "toolset:gcc", "options:pgo=generate"}
+        -- the loader and flecs' workers count too
+        buildoptions { "-fprofile-generate=" .. pgo_dir, "-fprofile-update=atomic" }
+        linkoptions { "-fprofile-generate=" .. pgo_dir }
+
+    filter {"configurations:PGO", "toolset:gcc", "options:pgo=use"}
+        -- rendering isn't trained, partial training keeps it optimized for speed rather than size.
+        -- main.c and the other tools' mains have no profile
+        buildoptions { "-fprofile-use=" .. pgo_dir, "-fprofile-partial-training", "-Wno-missing-profile" }
+        linkoptions { "-fprofile-use=" .. pgo_dir, "-fprofile-partial-training" }
+
+    -- simd.h goes 8 wide when the cpu has AVX. keep it the same for both PGO builds
+    filter {"options:native", "configurations:not Debug", "toolset:gcc or clang"}
+        buildoptions { "-march=native" }
+
     filter { "platforms:x64" }
         architecture "x86_64"
 
@@ -164,11 +270,11 @@ workspace (workspaceName)
         location "build_files/"
         targetdir "../bin/%{cfg.buildcfg}"
 
-        filter {"system:windows", "configurations:Release", "action:gmake*"}
+        filter {"system:windows", "configurations:not Debug", "action:gmake*"}
             kind "WindowedApp"
             buildoptions { "-Wl,--subsystem,windows" }
 
-        filter {"system:windows", "configurations:Release", "action:vs*"}
+        filter {"system:windows", "configurations:not Debug", "action:vs*"}
             kind "WindowedApp"
             entrypoint "mainCRTStartup"
 
@@ -193,40 +299,17 @@ workspace (workspaceName)
 
         filter{}
         
-        includedirs { "../src" }
-        includedirs { "../include" }
-
-        links {"raylib", "ccd"} -- added ccd link for 3D collision detection
-
-        cdialect "C17"
-        cppdialect "C++17"
-
-        includedirs {raylib_dir .. "/src" }
-        includedirs {raylib_dir .."/src/external" }
-        includedirs { raylib_dir .."/src/external/glfw/include" }
-        flags { "ShadowedVariables"}
-        platform_defines()
-
-        filter "action:vs*"
-            defines{"_WINSOCK_DEPRECATED_NO_WARNINGS", "_CRT_SECURE_NO_WARNINGS"}
-            dependson {"raylib"}
-            links {"raylib.lib"}
-            characterset ("Unicode")
-            buildoptions { "/Zc:__cplusplus" }
-
-        filter "system:windows"
-            defines{"_WIN32"}
-            links {"winmm", "gdi32", "opengl32"}
-            libdirs {"../bin/%{cfg.buildcfg}"}
-
-        filter "system:linux"
-            links {"pthread", "m", "dl", "rt", "X11" }
-
-        filter "system:macosx"
-            links {"OpenGL.framework", "Cocoa.framework", "IOKit.framework", "CoreFoundation.framework", "CoreAudio.framework", "CoreVideo.framework", "AudioToolbox.framework" }
-
-        filter{}
+        game_settings()
         
+    tool_project("gjk_bench", {"../bench/gjk_bench.c"})
+    tool_project("container_bench", {"../bench/container_bench.c"})
+    tool_project("spawn_bench", {"../bench/spawn_bench.c"})
+    tool_project("physics_bench", {"../bench/physics_bench.c"})
+    tool_project("snapshot_bench", {"../bench/snapshot_bench.c"})
+    tool_project("asset_bench", {"../bench/asset_bench.c"})
+    tool_project("collision_bench", {"../bench/collision_bench.c"})
+    tool_project("stress_bench", {"../bench/stress_bench.c"})
+
 
     project "raylib"
         kind "StaticLib"
@@ -254,6 +337,13 @@ workspace (workspaceName)
 
         removefiles {raylib_dir .. "/src/rcore_*.c"}
 
+        -- raylib's RL_MALLOC and friends go through memstats.c, it only defines them if they aren't already
+        forceincludes { "../src/memstats.h" }
+
+        -- plain ar can't index lto-only objects without its plugin, so keep real code in them as well
+        filter {"configurations:Release-LTO or PGO", "toolset:gcc"}
+            buildoptions { "-ffat-lto-objects" }
+
         filter { "system:macosx", "files:" .. raylib_dir .. "/src/rglfw.c" }
             compileas "Objective-C"
 
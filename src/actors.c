@@ -3,111 +3,198 @@
 #include "main.h"
 #include "models.h"
 #include "collision.h"
+#include "simd.h"
+#include "profiler.h"
 
 Vector3 gravity = { 0.0f, 0.0f, -GRAVITY };
+ActorPhaseTimes actorPhaseTimes;
+
+ECS_COMPONENT_DECLARE(ActorType);
+ECS_COMPONENT_DECLARE(Velocity);
+ECS_COMPONENT_DECLARE(GroundState);
+ECS_COMPONENT_DECLARE(ActorShape);
+ECS_COMPONENT_DECLARE(ContactManifold);
 
 Vector2 PickPerpendicular(Vector2 myDir, Vector2 wallDir);
 
-// Only apply friction when on ground
-void ActorFriction(Actor * actor) {
-    float speed = Vector3Length(actor->velocity);
-    if(speed < ACTOR_MIN_SPEED) {
-        actor->velocity.x = 0;
-        actor->velocity.y = 0;
-        actor->velocity.z = 0;
-        return;
+#define VELOCITY_STRIDE ((int)(sizeof(Velocity) / sizeof(float)))
+#define GROUND_STRIDE ((int)(sizeof(GroundState) / sizeof(float)))
+
+// one block of FLOAT8_LANES actors. grounded and airborne lanes are masked rather than branched
+void IntegrateActorBlock(Velocity * velocity, GroundState * ground, const bool * groundHit, Vector2 movedir, bool jump) {
+    Float8 mx = Float8Set1(movedir.x);
+    Float8 my = Float8Set1(movedir.y);
+    Float8 zero = Float8Set1(0.0f);
+    Float8 groundTime = Float8Set1(ACTOR_GROUND_TIME);
+
+    // columns are AoS, pull each field out into lanes
+    Float8 vx = Float8Gather(&velocity[0].x, VELOCITY_STRIDE);
+    Float8 vy = Float8Gather(&velocity[0].y, VELOCITY_STRIDE);
+    Float8 vz = Float8Gather(&velocity[0].z, VELOCITY_STRIDE);
+    Float8 g = Float8Make(ground[0].grounded, ground[1].grounded, ground[2].grounded, ground[3].grounded,
+        ground[4].grounded, ground[5].grounded, ground[6].grounded, ground[7].grounded);
+    Float8 hit = Float8Make(groundHit[0], groundHit[1], groundHit[2], groundHit[3],
+        groundHit[4], groundHit[5], groundHit[6], groundHit[7]);
+
+    // standing on something refreshes grounded, otherwise fall
+    hit = Float8Greater(hit, zero);
+    g = Float8Select(hit, groundTime, g);
+    vz = Float8Select(hit, vz, Float8Sub(vz, Float8Set1(GRAVITY)));
+
+    Float8 grounded = Float8Greater(g, zero);
+
+    // friction, grounded lanes only
+    Float8 speed = Float8Sqrt(Float8Add(Float8Add(Float8Mul(vx, vx), Float8Mul(vy, vy)), Float8Mul(vz, vz)));
+    Float8 stop = Float8Less(speed, Float8Set1(ACTOR_MIN_SPEED));
+    Float8 ratio = Float8Div(Float8Max(Float8Sub(speed, Float8Set1(ACTOR_FRICTION)), zero), speed);
+    vx = Float8Select(grounded, Float8AndNot(stop, Float8Mul(vx, ratio)), vx);
+    vy = Float8Select(grounded, Float8AndNot(stop, Float8Mul(vy, ratio)), vy);
+    vz = Float8Select(grounded, Float8AndNot(stop, Float8Mul(vz, ratio)), vz);
+
+    // accelerate in xy up to the ground or air max speed
+    Float8 maxSpeed = Float8Select(grounded, Float8Set1(ACTOR_MAX_SPEED), Float8Set1(ACTOR_AIR_MAX_SPEED));
+    Float8 addSpeed = Float8Sub(maxSpeed, Float8Add(Float8Mul(vx, mx), Float8Mul(vy, my)));
+    Float8 accel = Float8Min(addSpeed, Float8Set1(ACTOR_ACCEL));
+    Float8 accelerating = Float8Greater(addSpeed, zero);
+    vx = Float8Select(accelerating, Float8Add(vx, Float8Mul(mx, accel)), vx);
+    vy = Float8Select(accelerating, Float8Add(vy, Float8Mul(my, accel)), vy);
+    vz = Float8Select(accelerating, Float8Add(vz, zero), vz);     // movedir has no z, but adding it turns -0 into 0 like Vector3Add
+
+    // if on ground, cap downward velocity to prevent too much sliding
+    Float8 minZ = Float8Set1(-ACTOR_MAX_SPEED);
+    vz = Float8Select(Float8And(grounded, Float8Less(vz, minZ)), minZ, vz);
+
+    // remove component against ground
+    Float8 nx = Float8Gather(&ground[0].groundNormal.x, GROUND_STRIDE);
+    Float8 ny = Float8Gather(&ground[0].groundNormal.y, GROUND_STRIDE);
+    Float8 nz = Float8Gather(&ground[0].groundNormal.z, GROUND_STRIDE);
+    Float8 clip = Float8And(grounded, Float8Equal(g, groundTime));
+    Float8 backoff = Float8Add(Float8Add(Float8Mul(vx, nx), Float8Mul(vy, ny)), Float8Mul(vz, nz));
+    vx = Float8Select(clip, Float8Sub(vx, Float8Mul(nx, backoff)), vx);
+    vy = Float8Select(clip, Float8Sub(vy, Float8Mul(ny, backoff)), vy);
+    vz = Float8Select(clip, Float8Sub(vz, Float8Mul(nz, backoff)), vz);
+
+    if(jump) {
+        vz = Float8Select(grounded, Float8Add(vz, Float8Set1(0.5f)), vz);
+        g = Float8Select(grounded, zero, g);
     }
 
-    float newSpeed = speed - ACTOR_FRICTION;
-    if(newSpeed < 0)
-        newSpeed = 0;
-    
-    actor->velocity.x *= newSpeed/speed;
-    actor->velocity.y *= newSpeed/speed;
-    actor->velocity.z *= newSpeed/speed;
+    g = Float8Sub(g, Float8Set1(1.0f));
+
+    float lx[FLOAT8_LANES], ly[FLOAT8_LANES], lz[FLOAT8_LANES], lg[FLOAT8_LANES];
+    Float8Store(lx, vx);
+    Float8Store(ly, vy);
+    Float8Store(lz, vz);
+    Float8Store(lg, g);
+    for(int l = 0; l < FLOAT8_LANES; l ++) {
+        velocity[l] = (Velocity){ lx[l], ly[l], lz[l] };
+        ground[l].grounded = (int)lg[l];
+        assert(!VECTOR3_IS_NAN(velocity[l]));
+    }
 }
 
-void ActorAccelerate(Actor * actor, Vector3 movedir, bool grounded) {
-    assert(!VECTOR3_IS_NAN(actor->velocity));
-    Vector3 velocityXY = V2toV3(actor->velocity, 0);
-    float currentSpeed = Vector3DotProduct(velocityXY, movedir);
-    float maxSpeed = ACTOR_MAX_SPEED;
-    if(!grounded)
-        maxSpeed = ACTOR_AIR_MAX_SPEED;
-    
-    float addspeed = maxSpeed - currentSpeed;
-    
-    if(addspeed <= 0)
+// gravity, ground friction, acceleration and the clip against the ground for count actors, a block of
+// FLOAT8_LANES at a time. the tail is copied out and padded to a full block
+void IntegrateActors(Velocity * velocity, GroundState * ground, const bool * groundHit, int count, Vector2 movedir, bool jump) {
+    int base = 0;
+    for(; base + FLOAT8_LANES <= count; base += FLOAT8_LANES) {
+        IntegrateActorBlock(&velocity[base], &ground[base], &groundHit[base], movedir, jump);
+    }
+
+    int n = count - base;
+    if(n == 0)
         return;
-    float accel = ACTOR_ACCEL > addspeed ? addspeed : ACTOR_ACCEL;
 
-    actor->velocity = Vector3Add(actor->velocity, Vector3Scale(movedir, accel));
-    assert(!VECTOR3_IS_NAN(actor->velocity));
-}
+    Velocity tailVelocity[FLOAT8_LANES] = { 0 };
+    GroundState tailGround[FLOAT8_LANES] = { 0 };
+    bool tailHit[FLOAT8_LANES] = { 0 };
+    memcpy(tailVelocity, &velocity[base], sizeof(Velocity) * n);
+    memcpy(tailGround, &ground[base], sizeof(GroundState) * n);
+    memcpy(tailHit, &groundHit[base], sizeof(bool) * n);
 
-void ActorPhysics(Actor * actor, Position * position, Vector2 movedir) {
+    IntegrateActorBlock(tailVelocity, tailGround, tailHit, movedir, jump);
+
+    memcpy(&velocity[base], tailVelocity, sizeof(Velocity) * n);
+    memcpy(&ground[base], tailGround, sizeof(GroundState) * n);
+}
 
+// one table of actors, fields in q_actors order: Position, Velocity, GroundState, ContactManifold, ActorShape.
+// done in passes so each one streams only the columns it needs, actors don't collide with each other
+// so the order between them doesn't matter. only the ground test and the move are per actor
+void ActorPhysics(ecs_iter_t * it, Vector2 movedir, bool jump) {
+    PROFILE_BEGIN("ActorPhysics");
+    Position * position = ecs_field(it, Position, 0);
+    Velocity * velocity = ecs_field(it, Velocity, 1);
+    GroundState * ground = ecs_field(it, GroundState, 2);
+    ContactManifold * manifold = ecs_field(it, ContactManifold, 3);
+    ActorShape * shape = ecs_field(it, ActorShape, 4);
+    bool sharedShape = !ecs_field_is_self(it, 4);     // normally comes from the prefab
+
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+    Collision * groundCollision = ArenaAlloc(arena, sizeof(Collision) * it->count);
+    bool * groundHit = ArenaAlloc(arena, sizeof(bool) * it->count);
+    double phaseStart = (double)ecs_os_now();
+
+    // zones per pass, not per actor: a zone costs two clock reads and a lock, and a few thousand actors would
+    // push the frame's outer zones out of the ring
+    PROFILE_BEGIN("ground");
     // CHECK GROUNDED
     // TEST A POINT BELOW ACTOR
-    Collision groundCollision = { 0 };
-    groundCollision.hit = false;
-    groundCollision.depth = 0.0f;
-    groundCollision.direction = up;
-
-    ActorTestGround(actor, position, &groundCollision);
-    if(groundCollision.hit) {
-        actor->grounded = ACTOR_GROUND_TIME;
-        if(fabsf(groundCollision.depth) > ACTOR_GROUND_TEST_DIST) {
-            position->z += (groundCollision.depth - ACTOR_GROUND_TEST_DIST);
-            printf("DEEP\n");
-        }
-        else if(fabsf(groundCollision.depth) < ACTOR_GROUND_TEST_DIST/2) {
-            position->z -= ACTOR_GROUND_TEST_DIST/2;
-            printf("SHALLOW\n");
+    for(int i = 0; i < it->count; i ++) {
+        groundCollision[i] = (Collision){ 0 };
+        groundCollision[i].hit = false;
+        groundCollision[i].depth = 0.0f;
+        groundCollision[i].direction = up;
+
+        ActorTestGround(&ground[i], &position[i], &groundCollision[i]);
+        groundHit[i] = groundCollision[i].hit;
+        if(groundCollision[i].hit) {
+            if(fabsf(groundCollision[i].depth) > ACTOR_GROUND_TEST_DIST) {
+                position[i].z += (groundCollision[i].depth - ACTOR_GROUND_TEST_DIST);
+#if DEBUG
+                printf("DEEP\n");
+#endif
+            }
+            else if(fabsf(groundCollision[i].depth) < ACTOR_GROUND_TEST_DIST/2) {
+                position[i].z -= ACTOR_GROUND_TEST_DIST/2;
+#if DEBUG
+                printf("SHALLOW\n");
+#endif
+            }
         }
     }
-    else {
-        // apply gravity
-        actor->velocity = Vector3Add(actor->velocity, gravity);
-    }
-
-    // grounded
-    if(actor->grounded > 0) {
-        //Vector3 accel = GetTiltVector(movedir, actor->groundNormal);
-        Vector3 accel = V2toV3(movedir, 0);
-        ActorFriction(actor);
-        ActorAccelerate(actor, accel, true);
-
-        // if on ground, cap downward velocity to prevent too much sliding
-        if(actor->velocity.z < -ACTOR_MAX_SPEED) {
-            actor->velocity.z = -ACTOR_MAX_SPEED;
-        }
-
-        // remove component against ground
-        if(actor->grounded == ACTOR_GROUND_TIME) {
-            actor->velocity = ClipVector(actor->velocity, actor->groundNormal);
-        }
-
-        // jump
-        if(IsKeyPressed(KEY_SPACE)) {
-            actor->velocity = Vector3Add(actor->velocity, Vector3Scale(up, 0.5f));
-            actor->grounded = 0;
+    PROFILE_END();
+    double phaseEnd = (double)ecs_os_now();
+    actorPhaseTimes.ground += phaseEnd - phaseStart;
+    phaseStart = phaseEnd;
+
+    // velocity, the whole column at once
+    PROFILE_BEGIN("integrate");
+    IntegrateActors(velocity, ground, groundHit, it->count, movedir, jump);
+    PROFILE_END();
+    phaseEnd = (double)ecs_os_now();
+    actorPhaseTimes.integrate += phaseEnd - phaseStart;
+    phaseStart = phaseEnd;
+
+    // move
+    PROFILE_BEGIN("move");
+    for(int i = 0; i < it->count; i ++) {
+        const ActorShape * s = sharedShape ? &shape[0] : &shape[i];
+        MoveActorBox(s, &velocity[i], &ground[i], &position[i], &manifold[i], velocity[i], &groundCollision[i]);
+        //MoveActorBox(s, &velocity[i], &ground[i], &position[i], &manifold[i], velocity[i], NULL);
+        if(groundCollision[i].hit) {
+            ground[i].groundNormal = groundCollision[i].direction;
         }
+        //DrawRay((Ray){ position[i], ground[i].groundNormal }, GREEN);
+        //DrawRay((Ray){ position[i], velocity[i] }, YELLOW);
     }
-    else {
-        ActorAccelerate(actor, V2toV3(movedir, 0), false);
-    }
-
-    actor->grounded --;
+    PROFILE_END();
+    actorPhaseTimes.move += (double)ecs_os_now() - phaseStart;
+    actorPhaseTimes.actors += it->count;
 
-    MoveActorBox(actor, position, actor->velocity, &groundCollision);
-    //MoveActorBox(actor, position, actor->velocity, NULL);
-    if(groundCollision.hit) {
-        actor->groundNormal = groundCollision.direction;
-    }
-    //DrawRay((Ray){ *position, actor->groundNormal }, GREEN);
-    //DrawRay((Ray){ *position, actor->velocity }, YELLOW);
-    
+    ArenaRewind(arena, mark);
+    PROFILE_END();
 }
 
 // not in header, since this likely will only be used in movement code
@@ -143,62 +230,173 @@ float GetElevation(float x, float y, float z) {
     return FLT_MAX;
 }
 
-void ActorCollision(Actor * actor, Position * position, Collision c, Vector3 * move, Collision * groundCollision) {
-    if(move != NULL) {
-        Vector3 moveNormal = Vector3Normalize(*move);
-        float moveDist = Vector3Length(*move);
-        
-        float eject = Vector3DotProduct(moveNormal, Vector3Negate(c.direction)) * c.depth;
-        moveDist = moveDist - eject;
-        if(moveDist < 0)
-            moveDist = 0;
-        *move = Vector3Scale(moveNormal, moveDist);
-        if(Vector3Angle(*move, c.direction) > 90.0f*DEG2RAD)
-            actor->velocity = ClipVector(actor->velocity, c.direction);
+// GetElevation for a batch of points, walking the colliders once instead of once per point.
+// rays go straight down, so a collider can only be hit from points over its xy footprint
+void GetElevations(const Position * from, float * elevations, int count) {
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+    float * distances = ArenaAlloc(arena, sizeof(float) * count);
+
+    for(int i = 0; i < count; i ++) {
+        elevations[i] = FLT_MAX;
+        distances[i] = FLT_MAX;
     }
 
-    if(groundCollision != NULL) {
-        float groundAngle = Vector3Angle(up, c.direction);
-        if(groundAngle <= ACTOR_MAX_SLOPE) {
-            actor->grounded = ACTOR_GROUND_TIME;
-            groundCollision->hit = true;
-            if(Vector3DotProduct(c.direction, up) < Vector3DotProduct(groundCollision->direction, up)) {
-                groundCollision->direction = c.direction;
+    ecs_iter_t it = ecs_query_iter(world, q_MeshCollider);
+    while(ecs_query_next(&it)) {
+        MeshCollider * colliders = ecs_field(&it, MeshCollider, 0);
+
+        for(int c = 0; c < it.count; c ++) {
+            BoundingBox box = colliders[c].worldBox;
+
+            for(int i = 0; i < count; i ++) {
+                Position p = from[i];
+                if(p.x < box.min.x || p.x > box.max.x || p.y < box.min.y || p.y > box.max.y || p.z < box.min.z)
+                    continue;
+
+                RayCollision hit = GetRayCollisionMesh((Ray){ p, down }, *colliders[c].mesh, colliders[c].transform);
+                if(hit.hit && Vector3Angle(down, hit.normal)*RAD2DEG >= 90.0f && hit.distance < distances[i]) {
+                    distances[i] = hit.distance;
+                    elevations[i] = hit.point.z;
+                }
             }
-            if(c.depth > groundCollision->depth) {
-                groundCollision->depth = c.depth;
-                groundCollision->point = c.point;
+        }
+    }
+
+    it = ecs_query_iter(world, q_BoxCollider);
+    while(ecs_query_next(&it)) {
+        BoxCollider * boxes = ecs_field(&it, BoxCollider, 0);
+
+        for(int c = 0; c < it.count; c ++) {
+            BoxCollider box = boxes[c];
+
+            for(int i = 0; i < count; i ++) {
+                Position p = from[i];
+                if(p.x < box.min.x || p.x > box.max.x || p.y < box.min.y || p.y > box.max.y || p.z < box.min.z)
+                    continue;
+
+                RayCollision hit = GetRayCollisionBox((Ray){ p, down }, box);
+                if(hit.hit && hit.distance < distances[i]) {
+                    distances[i] = hit.distance;
+                    elevations[i] = hit.point.z;
+                }
             }
         }
     }
 
-    //actor->velocity = ClipVector(actor->velocity, c.direction);
+    ArenaRewind(arena, mark);
+}
+
+// creates count actors of one type with ecs_bulk_init, so each lands straight in its final table
+// instead of moving once per ecs_set. prefab has to carry the ActorShape, directly or through its own IsA.
+// positions are dropped to the ground first, z is the height to drop from. ids of the new entities go
+// in out if it isn't NULL
+void SpawnActors(ecs_entity_t prefab, ACTOR_TYPE type, const Position * positions, int count, ecs_entity_t * out) {
+    Arena * arena = FrameArena();
+
+    for(int start = 0; start < count; start += ACTOR_SPAWN_BATCH) {
+        int n = count - start < ACTOR_SPAWN_BATCH ? count - start : ACTOR_SPAWN_BATCH;
+        size_t mark = ArenaMark(arena);
+
+        Position * position = ArenaAlloc(arena, sizeof(Position) * n);
+        ActorType * actorType = ArenaAlloc(arena, sizeof(ActorType) * n);
+        Velocity * velocity = ArenaAlloc(arena, sizeof(Velocity) * n);
+        GroundState * ground = ArenaAlloc(arena, sizeof(GroundState) * n);
+        float * elevations = ArenaAlloc(arena, sizeof(float) * n);
+
+        GetElevations(&positions[start], elevations, n);
+
+        for(int i = 0; i < n; i ++) {
+            position[i] = positions[start + i];
+            position[i].z = elevations[i] == FLT_MAX ? 0.0f : elevations[i];
+            actorType[i] = (ActorType){ type };
+            velocity[i] = (Velocity){ 0 };
+            ground[i] = (GroundState){ .groundNormal = up };
+        }
+
+        InsertActors(prefab, actorType, position, velocity, ground, n, out != NULL ? &out[start] : NULL);
 
-    //DrawRay((Ray){ *position, c.direction }, RED);
+        ArenaRewind(arena, mark);
+    }
 }
 
-float MoveActorBox(Actor * actor, Position * position, Vector3 move, Collision * groundCollision) {
+void InsertActors(ecs_entity_t prefab, const ActorType * types, const Position * positions, const Velocity * velocities,
+    const GroundState * grounds, int count, ecs_entity_t * out) {
+    Arena * arena = FrameArena();
+
+    for(int start = 0; start < count; start += ACTOR_SPAWN_BATCH) {
+        int n = count - start < ACTOR_SPAWN_BATCH ? count - start : ACTOR_SPAWN_BATCH;
+        size_t mark = ArenaMark(arena);
+
+        // contacts and camera distance are rebuilt every frame, so they start out empty
+        ContactManifold * manifold = ArenaAlloc(arena, sizeof(ContactManifold) * n);
+        CamDistance * camDistance = ArenaAlloc(arena, sizeof(CamDistance) * n);
+        memset(manifold, 0, sizeof(ContactManifold) * n);
+        memset(camDistance, 0, sizeof(CamDistance) * n);
+
+        // bulk_init copies, so the inputs can be read only (or mapped from a file)
+        const ecs_entity_t * spawned = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+            .count = n,
+            .ids = { ecs_pair(EcsIsA, prefab), ecs_id(CamDistance), ecs_id(ActorType), ecs_id(Velocity), ecs_id(GroundState),
+                ecs_id(ContactManifold), ecs_id(Position) },
+            .data = (void *[]){ NULL, camDistance, (void *)&types[start], (void *)&velocities[start], (void *)&grounds[start],
+                manifold, (void *)&positions[start] },
+        });
+
+        if(out != NULL)
+            memcpy(&out[start], spawned, sizeof(ecs_entity_t) * n);
+
+        ArenaRewind(arena, mark);
+    }
+}
 
-    float moveDist = Vector3Length(move);
-    Vector3 moveNormal = Vector3Normalize(move);
+// count c as ground if it isn't too steep to stand on
+void ActorGroundContact(GroundState * ground, Collision c, Collision * groundCollision) {
+    float groundAngle = Vector3Angle(up, c.direction);
+    if(groundAngle <= ACTOR_MAX_SLOPE) {
+        ground->grounded = ACTOR_GROUND_TIME;
+        groundCollision->hit = true;
+        if(Vector3DotProduct(c.direction, up) < Vector3DotProduct(groundCollision->direction, up)) {
+            groundCollision->direction = c.direction;
+        }
+        if(c.depth > groundCollision->depth) {
+            groundCollision->depth = c.depth;
+            groundCollision->point = c.point;
+        }
+    }
+}
+
+void AddActorContact(ContactManifold * manifold, Collision c, ecs_entity_t collider) {
+    Contact contact = { c.direction, c.depth, c.point, collider, 0.0f };
+
+    if(manifold->count < ACTOR_MAX_CONTACTS) {
+        manifold->contacts[manifold->count ++] = contact;
+        return;
+    }
+
+    // full, so replace the shallowest contact if this one matters more
+    int shallowest = 0;
+    for(int i = 1; i < manifold->count; i ++) {
+        if(manifold->contacts[i].depth < manifold->contacts[shallowest].depth)
+            shallowest = i;
+    }
+    if(contact.depth > manifold->contacts[shallowest].depth)
+        manifold->contacts[shallowest] = contact;
+}
+
+// collect everything the box overlaps in one pass, nothing gets resolved until all are known
+void GatherActorContacts(BoundingBox box, ContactManifold * manifold) {
+    manifold->count = 0;
 
-    // what's our box after moving the full distance?
-    Position target = Vector3Add(*position, move);
-    BoundingBox targetBox = BoundingBoxAdd(*actor->box, target);
-#if DEBUG
-    DrawBoundingBox(targetBox, RED);
-#endif
     // boxes (non actor)
     ecs_iter_t it = ecs_query_iter(world, q_BoxColliderNotActor);
     while (ecs_query_next(&it))  {
         BoxCollider * colliders = ecs_field(&it, BoxCollider, 0);
 
         for(int i = 0; i < it.count; i ++) {
-            BoxCollider box = colliders[i];
-
-            Collision c = BoxBoxCollision(targetBox, box);
+            Collision c = BoxBoxCollision(box, colliders[i]);
             if(c.hit) {
-                ActorCollision(actor, position, c, &move, groundCollision);
+                AddActorContact(manifold, c, it.entities[i]);
             }
         }
     }
@@ -209,29 +407,154 @@ float MoveActorBox(Actor * actor, Position * position, Vector3 move, Collision *
         MeshCollider * colliders = ecs_field(&it, MeshCollider, 0);
 
         for(int i = 0; i < it.count; i ++) {
-            MeshCollider collider = colliders[i];
+            // the solver pushes along each normal, so this needs the minimum translation.
+            // MPR's normal follows the line from the mesh center and tips sideways near slab edges
+            Collision c = BoxMeshCollisionTier(box, colliders[i], COLLISION_EXACT);
+            if(c.hit) {
+                AddActorContact(manifold, c, it.entities[i]);
+            }
+        }
+    }
+}
 
-            Collision c = BoxMeshCollision(targetBox, collider);
+// start each contact from last frame's push against the same collider, if it's still facing the same way
+void WarmStartActorContacts(ContactManifold * manifold, const ContactManifold * previous) {
+    for(int i = 0; i < manifold->count; i ++) {
+        Contact * contact = &manifold->contacts[i];
+        for(int j = 0; j < previous->count; j ++) {
+            const Contact * old = &previous->contacts[j];
+            if(old->collider == contact->collider && Vector3DotProduct(old->normal, contact->normal) > ACTOR_CONTACT_MATCH) {
+                contact->push = old->push;
+                break;
+            }
+        }
+    }
+}
 
-            if(c.hit) {
-                ActorCollision(actor, position, c, &move, groundCollision);
+// projected gauss-seidel over the contact planes
+// the correction is a sum of pushes along each normal, none of them negative,
+// that leaves every contact at most ACTOR_CONTACT_SLOP deep
+Vector3 SolveActorContacts(ContactManifold * manifold) {
+    Vector3 correction = { 0 };
+    for(int i = 0; i < manifold->count; i ++) {
+        Contact * contact = &manifold->contacts[i];
+        correction = Vector3Add(correction, Vector3Scale(contact->normal, contact->push));
+    }
+
+    for(int iter = 0; iter < ACTOR_SOLVER_ITERATIONS; iter ++) {
+        for(int i = 0; i < manifold->count; i ++) {
+            Contact * contact = &manifold->contacts[i];
+            float error = (contact->depth - ACTOR_CONTACT_SLOP) - Vector3DotProduct(contact->normal, correction);
+            float push = contact->push + error;
+            if(push < 0)
+                push = 0;
+
+            correction = Vector3Add(correction, Vector3Scale(contact->normal, push - contact->push));
+            contact->push = push;
+        }
+    }
+
+    return correction;
+}
+
+// earliest contact along the move, ignoring anything we're already touching
+TimeOfImpact SweepActorBox(const ActorShape * shape, Position * position, Vector3 move) {
+    TimeOfImpact first = { false, 1.0f };
+
+    BoundingBox startBox = BoundingBoxAdd(*shape, *position);
+
+    // boxes (non actor)
+    ecs_iter_t it = ecs_query_iter(world, q_BoxColliderNotActor);
+    while (ecs_query_next(&it))  {
+        BoxCollider * colliders = ecs_field(&it, BoxCollider, 0);
+
+        for(int i = 0; i < it.count; i ++) {
+            TimeOfImpact t = BoxBoxSweep(startBox, move, colliders[i]);
+            if(t.hit && t.toi > 0.0f && t.toi < first.toi) {
+                first = t;
+            }
+        }
+    }
+
+    // meshes
+    it = ecs_query_iter(world, q_MeshCollider);
+    while (ecs_query_next(&it))  {
+        MeshCollider * colliders = ecs_field(&it, MeshCollider, 0);
+
+        for(int i = 0; i < it.count; i ++) {
+            TimeOfImpact t = BoxMeshSweep(startBox, move, colliders[i]);
+            if(t.hit && t.toi > 0.0f && t.toi < first.toi) {
+                first = t;
             }
         }
     }
-    *position = Vector3Add(*position, move);
+
+    return first;
+}
+
+float MoveActorBox(const ActorShape * shape, Velocity * velocity, GroundState * ground, Position * position, ContactManifold * manifold, Vector3 move, Collision * groundCollision) {
+    COLLISION_COUNT(actorMoves, 1);
+
+    float moveDist = Vector3Length(move);
+
+    // stop at the first thing we'd pass through and slide the rest of the way along it,
+    // so fast moves can't skip over thin geometry between start and target
+    TimeOfImpact toi = SweepActorBox(shape, position, move);
+    if(toi.hit) {
+        Vector3 reach = Vector3Scale(move, toi.toi);
+        Vector3 rest = ClipVector(Vector3Subtract(move, reach), toi.normal);
+        move = Vector3Add(reach, rest);
+        if(Vector3DotProduct(*velocity, toi.normal) < 0)
+            *velocity = ClipVector(*velocity, toi.normal);
+    }
+
+    // what's our box after moving the full distance?
+    Position target = Vector3Add(*position, move);
+    BoundingBox targetBox = BoundingBoxAdd(*shape, target);
+#if DRAWWIRES
+    DrawBoundingBox(targetBox, RED);
+#endif
+
+    ContactManifold previous = *manifold;
+    GatherActorContacts(targetBox, manifold);
+    WarmStartActorContacts(manifold, &previous);
+
+    Vector3 correction = SolveActorContacts(manifold);
+
+    // clip velocity against every contact plane we're heading into,
+    // twice so a crease between two planes clips along both
+    for(int pass = 0; pass < 2; pass ++) {
+        for(int i = 0; i < manifold->count; i ++) {
+            Vector3 normal = manifold->contacts[i].normal;
+            if(Vector3DotProduct(*velocity, normal) < 0)
+                *velocity = ClipVector(*velocity, normal);
+        }
+    }
+
+    if(groundCollision != NULL) {
+        for(int i = 0; i < manifold->count; i ++) {
+            Contact * contact = &manifold->contacts[i];
+            ActorGroundContact(ground, (Collision){ true, contact->depth, contact->normal, contact->point }, groundCollision);
+        }
+    }
+
+    *position = Vector3Add(target, correction);
 
     return moveDist;
 }
 
-void ActorTestGround(Actor * actor, Position * position, Collision * groundCollision) {
+void ActorTestGround(GroundState * ground, Position * position, Collision * groundCollision) {
+    COLLISION_COUNT(groundTests, 1);
 
     // what's our box after moving the full distance?
     Position target = *position;
     target.z -= ACTOR_GROUND_TEST_DIST;
 
-    //BoundingBox targetBox = BoundingBoxAdd(*actor->box, target);
+    //BoundingBox targetBox = BoundingBoxAdd(*shape, target);
 
+#if DRAWWIRES
     DrawCube(target, 0.05f, 0.05f, 0.05f, RED);
+#endif
 
     // boxes (non actor)
     ecs_iter_t it = ecs_query_iter(world, q_BoxColliderNotActor);
@@ -245,7 +568,7 @@ void ActorTestGround(Actor * actor, Position * position, Collision * groundColli
             //Collision c = BoxBoxCollision(targetBox, box);
 
             if(c.hit) {
-                ActorCollision(actor, position, c, NULL, groundCollision);
+                ActorGroundContact(ground, c, groundCollision);
             }
         }
     }
@@ -258,11 +581,12 @@ void ActorTestGround(Actor * actor, Position * position, Collision * groundColli
         for(int i = 0; i < it.count; i ++) {
             MeshCollider collider = colliders[i];
 
-            Collision c = PointMeshCollision(target, collider);
+            // slope check needs the real surface normal, which MPR only gets when the mesh center is under us
+            Collision c = PointMeshCollisionTier(target, collider, COLLISION_EXACT);
             //Collision c = BoxMeshCollision(targetBox, collider);
 
             if(c.hit) {
-                ActorCollision(actor, position, c, NULL, groundCollision);
+                ActorGroundContact(ground, c, groundCollision);
             }
         }
     }
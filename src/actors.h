@@ -23,13 +23,55 @@ typedef enum {
 #define ACTOR_MAX_SLOPE 50.0f * DEG2RAD
 #define ACTOR_GROUND_TIME 5     // how many frames still considered grounded after leaving ground
 
-typedef struct Actor {
+// an actor is split by access pattern, so passes over actors only stream the columns they touch
+typedef struct ActorType {
     ACTOR_TYPE type;
-    Vector3 velocity;
-    BoxCollider * box;
+} ActorType;
+
+typedef Vector3 Velocity;
+
+typedef struct GroundState {
     int grounded;
     Vector3 groundNormal;
-} Actor;
+} GroundState;
+
+// box around the actor's feet, set on the prefab and shared by every instance
+typedef BoundingBox ActorShape;
+
+extern ECS_COMPONENT_DECLARE(ActorType);
+extern ECS_COMPONENT_DECLARE(Velocity);
+extern ECS_COMPONENT_DECLARE(GroundState);
+extern ECS_COMPONENT_DECLARE(ActorShape);
+
+#define ACTOR_MAX_CONTACTS 8
+#define ACTOR_SOLVER_ITERATIONS 4
+#define ACTOR_CONTACT_SLOP ACTOR_GROUND_TEST_DIST   // depth left alone, so resting contacts don't jitter
+#define ACTOR_CONTACT_MATCH 0.9f                    // normals this close count as the same contact next frame
+
+typedef struct Contact {
+    Vector3 normal;
+    float depth;
+    Vector3 point;
+    ecs_entity_t collider;
+    float push;             // solved push along normal, kept for warm starting
+} Contact;
+
+// all of an actor's contacts from its last move
+typedef struct ContactManifold {
+    Contact contacts[ACTOR_MAX_CONTACTS];
+    int count;
+} ContactManifold;
+
+extern ECS_COMPONENT_DECLARE(ContactManifold);
+
+// ActorShape is inherited rather than copied, so queries pick it up from the prefab
+#define ECS_ACTOR_COMPONENTS() \
+ECS_COMPONENT_DEFINE(world, ActorType); \
+ECS_COMPONENT_DEFINE(world, Velocity); \
+ECS_COMPONENT_DEFINE(world, GroundState); \
+ECS_COMPONENT_DEFINE(world, ActorShape); \
+ECS_COMPONENT_DEFINE(world, ContactManifold); \
+ecs_add_pair(world, ecs_id(ActorShape), EcsOnInstantiate, EcsInherit)
 
 #define GRAVITY 9.8f / 360.0f // -9.8f / 60.0f
 extern Vector3 gravity;
@@ -47,13 +89,33 @@ extern Vector3 gravity;
 #define PERPL(V2) (Vector2){ -V2.y, V2.x }
 #define PERPR(V2) (Vector2){ V2.y, -V2.x }
 
-void ActorPhysics(Actor * actor, Position * position, Vector2 movement);
+// ns ActorPhysics spent in each of its passes, and how many actors went through, added up until someone clears it
+typedef struct ActorPhaseTimes {
+    double ground;
+    double integrate;
+    double move;
+    int64_t actors;
+} ActorPhaseTimes;
+
+extern ActorPhaseTimes actorPhaseTimes;
+
+void ActorPhysics(ecs_iter_t * it, Vector2 movement, bool jump);
+void IntegrateActors(Velocity * velocity, GroundState * ground, const bool * groundHit, int count, Vector2 movedir, bool jump);
 Vector3 GetTiltVector(Vector2 vec, Vector3 normal);
 
 float GetElevation(float x, float y, float z);
+void GetElevations(const Position * from, float * elevations, int count);
+
+#define ACTOR_SPAWN_BATCH 1024  // actors per ecs_bulk_init, keeps the temporaries small enough for the frame arena
+
+void SpawnActors(ecs_entity_t prefab, ACTOR_TYPE type, const Position * positions, int count, ecs_entity_t * out);
+// actors whose state is already known (a snapshot), placed as given
+void InsertActors(ecs_entity_t prefab, const ActorType * types, const Position * positions, const Velocity * velocities,
+    const GroundState * grounds, int count, ecs_entity_t * out);
 
-float MoveActorBox(Actor * actor, Position * position, Vector3 move, Collision * groundCollision);
-void ActorTestGround(Actor * actor, Position * position, Collision * groundCollision);
+TimeOfImpact SweepActorBox(const ActorShape * shape, Position * position, Vector3 move);
+float MoveActorBox(const ActorShape * shape, Velocity * velocity, GroundState * ground, Position * position, ContactManifold * manifold, Vector3 move, Collision * groundCollision);
+void ActorTestGround(GroundState * ground, Position * position, Collision * groundCollision);
 
 typedef enum {
     SPRITE_RED,
@@ -0,0 +1,400 @@
+#include "allocator.h"
+#include "headers.h"
+
+#include <string.h>
+
+typedef struct PoolHeader {
+    int32_t sizeClass;          // -1 for large allocations, POOL_UNPOOLED from a thread without a pool
+    int32_t size;
+    int64_t pad;
+} PoolHeader;
+
+typedef struct PoolBlock {
+    struct PoolBlock * next;
+} PoolBlock;
+
+typedef struct PoolClass {
+    PoolBlock * freeList;
+    char * chunk;               // current chunk blocks are carved from
+    int32_t chunkUsed;
+    char * chunks;              // all of them, chained through their first POOL_HEADER_SIZE bytes
+} PoolClass;
+
+typedef struct ThreadPool {
+    PoolClass classes[POOL_CLASS_COUNT];
+    PoolStats stats;
+} ThreadPool;
+
+static THREAD_LOCAL ThreadPool * threadPool = NULL;
+static THREAD_LOCAL bool threadUnpooled = false;
+
+// every thread's pool, so stats can be summed. a pool outlives its thread, the next thread to start
+// takes it over with whatever is still on its free lists
+static ThreadPool * threadPools[POOL_MAX_THREADS];
+static bool threadPoolReleased[POOL_MAX_THREADS];
+static int32_t threadPoolCount = 0;
+static ecs_os_mutex_t threadPoolsLock;
+
+// blocks freed by threads without a pool, under threadPoolsLock. pooled threads adopt them
+// before carving new blocks
+static PoolBlock * orphans[POOL_CLASS_COUNT];
+static PoolStats orphanStats;
+
+static ecs_os_api_thread_new_t nextThreadNew;
+static ecs_os_api_thread_new_t nextTaskNew;
+
+// NULL once all POOL_MAX_THREADS pools are taken, that thread goes straight to malloc
+static ThreadPool * GetThreadPool(void) {
+    if(threadPool != NULL || threadUnpooled)
+        return threadPool;
+
+    ecs_os_mutex_lock(threadPoolsLock);
+    for(int i = 0; i < threadPoolCount; i ++) {
+        if(threadPoolReleased[i]) {
+            threadPoolReleased[i] = false;
+            threadPool = threadPools[i];
+            break;
+        }
+    }
+    if(threadPool == NULL && threadPoolCount < POOL_MAX_THREADS) {
+        threadPool = calloc(1, sizeof(ThreadPool));
+        for(int i = 0; i < POOL_CLASS_COUNT; i ++) {
+            threadPool->stats.classes[i].blockSize = POOL_MIN_SIZE << i;
+        }
+        threadPools[threadPoolCount] = threadPool;
+        threadPoolCount ++;
+    }
+    ecs_os_mutex_unlock(threadPoolsLock);
+
+    static int32_t warned = 0;
+    if(threadPool == NULL) {
+        threadUnpooled = true;
+        if(ecs_os_ainc(&warned) == 1)
+            printf("allocator: more than %d threads, the rest use malloc\n", POOL_MAX_THREADS);
+    }
+    return threadPool;
+}
+
+static void ReleaseThreadPool(void) {
+    if(threadPool == NULL)
+        return;
+
+    ecs_os_mutex_lock(threadPoolsLock);
+    for(int i = 0; i < threadPoolCount; i ++) {
+        if(threadPools[i] == threadPool)
+            threadPoolReleased[i] = true;
+    }
+    ecs_os_mutex_unlock(threadPoolsLock);
+    threadPool = NULL;
+}
+
+// flecs starts every worker and loader thread, so that's where their pools are handed back
+typedef struct PoolThread {
+    ecs_os_thread_callback_t callback;
+    void * param;
+} PoolThread;
+
+static void * PoolThreadMain(void * param) {
+    PoolThread thread = *(PoolThread *)param;
+    free(param);
+
+    void * result = thread.callback(thread.param);
+    ReleaseThreadPool();
+    return result;
+}
+
+static PoolThread * NewPoolThread(ecs_os_thread_callback_t callback, void * param) {
+    PoolThread * thread = malloc(sizeof(PoolThread));
+    thread->callback = callback;
+    thread->param = param;
+    return thread;
+}
+
+static ecs_os_thread_t PoolThreadNew(ecs_os_thread_callback_t callback, void * param) {
+    return nextThreadNew(PoolThreadMain, NewPoolThread(callback, param));
+}
+
+static ecs_os_thread_t PoolTaskNew(ecs_os_thread_callback_t callback, void * param) {
+    return nextTaskNew(PoolThreadMain, NewPoolThread(callback, param));
+}
+
+static int SizeClass(int32_t size) {
+    int sizeClass = 0;
+    int32_t blockSize = POOL_MIN_SIZE;
+    while(blockSize < size) {
+        blockSize <<= 1;
+        sizeClass ++;
+    }
+    return sizeClass;
+}
+
+static void TrackAlloc(PoolStats * stats, PoolClassStats * cs, int32_t size) {
+    cs->allocs ++;
+    cs->blocksInUse ++;
+    cs->bytesInUse += size;
+    if(cs->bytesInUse > cs->peakBytes)
+        cs->peakBytes = cs->bytesInUse;
+
+    stats->bytesInUse += size;
+    if(stats->bytesInUse > stats->peakBytes)
+        stats->peakBytes = stats->bytesInUse;
+}
+
+static void * ClassAlloc(ThreadPool * pool, int sizeClass, int32_t size) {
+    PoolClass * pc = &pool->classes[sizeClass];
+    PoolClassStats * cs = &pool->stats.classes[sizeClass];
+    int32_t blockSize = POOL_HEADER_SIZE + cs->blockSize;
+
+    if(pc->freeList == NULL && orphans[sizeClass] != NULL) {
+        ecs_os_mutex_lock(threadPoolsLock);
+        pc->freeList = orphans[sizeClass];
+        orphans[sizeClass] = NULL;
+        ecs_os_mutex_unlock(threadPoolsLock);
+    }
+
+    PoolHeader * header;
+    if(pc->freeList != NULL) {
+        header = (PoolHeader *)pc->freeList;
+        pc->freeList = pc->freeList->next;
+    }
+    else {
+        if(pc->chunk == NULL || pc->chunkUsed + blockSize > POOL_CHUNK_SIZE) {
+            pc->chunk = malloc(POOL_CHUNK_SIZE);
+            *(char **)pc->chunk = pc->chunks;
+            pc->chunks = pc->chunk;
+            pc->chunkUsed = POOL_HEADER_SIZE;
+            pool->stats.chunkBytes += POOL_CHUNK_SIZE;
+        }
+        header = (PoolHeader *)(pc->chunk + pc->chunkUsed);
+        pc->chunkUsed += blockSize;
+        cs->blocksReserved ++;
+    }
+
+    header->sizeClass = sizeClass;
+    header->size = size;
+    TrackAlloc(&pool->stats, cs, size);
+
+    return (char *)header + POOL_HEADER_SIZE;
+}
+
+static void * PoolAllocate(int32_t size) {
+    assert(size > 0);
+
+    ThreadPool * pool = GetThreadPool();
+
+    if(pool == NULL) {
+        PoolHeader * header = malloc(POOL_HEADER_SIZE + size);
+        header->sizeClass = POOL_UNPOOLED;
+        header->size = size;
+        return (char *)header + POOL_HEADER_SIZE;
+    }
+
+    if(size > POOL_MAX_SIZE) {
+        PoolHeader * header = malloc(POOL_HEADER_SIZE + size);
+        header->sizeClass = -1;
+        header->size = size;
+
+        PoolStats * stats = &pool->stats;
+        stats->largeAllocs ++;
+        stats->largeBytesInUse += size;
+        if(stats->largeBytesInUse > stats->largePeakBytes)
+            stats->largePeakBytes = stats->largeBytesInUse;
+        stats->bytesInUse += size;
+        if(stats->bytesInUse > stats->peakBytes)
+            stats->peakBytes = stats->bytesInUse;
+
+        return (char *)header + POOL_HEADER_SIZE;
+    }
+
+    return ClassAlloc(pool, SizeClass(size), size);
+}
+
+static void ReleaseOrphan(PoolHeader * header) {
+    ecs_os_mutex_lock(threadPoolsLock);
+    orphanStats.bytesInUse -= header->size;
+    if(header->sizeClass < 0) {
+        orphanStats.largeBytesInUse -= header->size;
+        free(header);
+    }
+    else {
+        PoolClassStats * cs = &orphanStats.classes[header->sizeClass];
+        cs->blocksInUse --;
+        cs->bytesInUse -= header->size;
+
+        PoolBlock * block = (PoolBlock *)header;
+        block->next = orphans[header->sizeClass];
+        orphans[header->sizeClass] = block;
+    }
+    ecs_os_mutex_unlock(threadPoolsLock);
+}
+
+// a block freed on another thread joins that thread's free list, so memory can drift between
+// pools but is never lost
+static void PoolRelease(void * ptr) {
+    PoolHeader * header = (PoolHeader *)((char *)ptr - POOL_HEADER_SIZE);
+    if(header->sizeClass == POOL_UNPOOLED) {
+        free(header);
+        return;
+    }
+
+    ThreadPool * pool = GetThreadPool();
+    if(pool == NULL) {
+        ReleaseOrphan(header);
+        return;
+    }
+
+    pool->stats.bytesInUse -= header->size;
+
+    if(header->sizeClass < 0) {
+        pool->stats.largeBytesInUse -= header->size;
+        free(header);
+        return;
+    }
+
+    PoolClassStats * cs = &pool->stats.classes[header->sizeClass];
+    cs->blocksInUse --;
+    cs->bytesInUse -= header->size;
+
+    PoolClass * pc = &pool->classes[header->sizeClass];
+    PoolBlock * block = (PoolBlock *)header;
+    block->next = pc->freeList;
+    pc->freeList = block;
+}
+
+// the os api hooks keep flecs' own alloc counters going, same as its defaults
+
+void * PoolMalloc(ecs_size_t size) {
+    ecs_os_linc(&ecs_os_api_malloc_count);
+    return PoolAllocate(size);
+}
+
+void * PoolCalloc(ecs_size_t size) {
+    ecs_os_linc(&ecs_os_api_calloc_count);
+    void * ptr = PoolAllocate(size);
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void PoolFree(void * ptr) {
+    if(ptr == NULL)
+        return;
+
+    ecs_os_linc(&ecs_os_api_free_count);
+    PoolRelease(ptr);
+}
+
+void * PoolRealloc(void * ptr, ecs_size_t size) {
+    if(ptr == NULL)
+        return PoolMalloc(size);
+
+    ecs_os_linc(&ecs_os_api_realloc_count);
+
+    PoolHeader * header = (PoolHeader *)((char *)ptr - POOL_HEADER_SIZE);
+
+    // still fits the block it's in, just fix up the counts
+    ThreadPool * pool = GetThreadPool();
+    if(pool != NULL && header->sizeClass >= 0 && size <= (POOL_MIN_SIZE << header->sizeClass)) {
+        PoolClassStats * cs = &pool->stats.classes[header->sizeClass];
+        cs->bytesInUse += size - header->size;
+        pool->stats.bytesInUse += size - header->size;
+        if(pool->stats.bytesInUse > pool->stats.peakBytes)
+            pool->stats.peakBytes = pool->stats.bytesInUse;
+        header->size = size;
+        return ptr;
+    }
+
+    void * newPtr = PoolAllocate(size);
+    memcpy(newPtr, ptr, header->size < size ? header->size : size);
+    PoolRelease(ptr);
+    return newPtr;
+}
+
+// call after ecs_os_set_api_defaults() and before ecs_init(), before flecs has allocated anything
+void InstallPoolAllocator(void) {
+    threadPoolsLock = ecs_os_mutex_new();
+
+    ecs_os_api_t api = ecs_os_get_api();
+    nextThreadNew = api.thread_new_;
+    nextTaskNew = api.task_new_;
+    api.thread_new_ = PoolThreadNew;
+    api.task_new_ = PoolTaskNew;
+    api.malloc_ = PoolMalloc;
+    api.calloc_ = PoolCalloc;
+    api.realloc_ = PoolRealloc;
+    api.free_ = PoolFree;
+    ecs_os_set_api(&api);
+}
+
+void FreePoolAllocator(void) {
+    ecs_os_mutex_lock(threadPoolsLock);
+    for(int t = 0; t < threadPoolCount; t ++) {
+        for(int i = 0; i < POOL_CLASS_COUNT; i ++) {
+            char * chunk = threadPools[t]->classes[i].chunks;
+            while(chunk != NULL) {
+                char * next = *(char **)chunk;
+                free(chunk);
+                chunk = next;
+            }
+        }
+        free(threadPools[t]);
+        threadPools[t] = NULL;
+        threadPoolReleased[t] = false;
+    }
+    threadPoolCount = 0;
+    memset(orphans, 0, sizeof(orphans));
+    orphanStats = (PoolStats){ 0 };
+    ecs_os_mutex_unlock(threadPoolsLock);
+
+    // the other threads are gone by now, a later allocation here starts a fresh pool
+    threadPool = NULL;
+}
+
+PoolStats GetPoolStats(void) {
+    PoolStats total = { 0 };
+    for(int i = 0; i < POOL_CLASS_COUNT; i ++) {
+        total.classes[i].blockSize = POOL_MIN_SIZE << i;
+    }
+
+    int32_t count = threadPoolCount;
+    for(int t = 0; t <= count; t ++) {
+        PoolStats * stats = t < count ? &threadPools[t]->stats : &orphanStats;
+        for(int i = 0; i < POOL_CLASS_COUNT; i ++) {
+            PoolClassStats * cs = &stats->classes[i];
+            total.classes[i].allocs += cs->allocs;
+            total.classes[i].blocksInUse += cs->blocksInUse;
+            total.classes[i].blocksReserved += cs->blocksReserved;
+            total.classes[i].bytesInUse += cs->bytesInUse;
+            total.classes[i].peakBytes += cs->peakBytes;
+        }
+        total.largeAllocs += stats->largeAllocs;
+        total.largeBytesInUse += stats->largeBytesInUse;
+        total.largePeakBytes += stats->largePeakBytes;
+        total.chunkBytes += stats->chunkBytes;
+        total.bytesInUse += stats->bytesInUse;
+        total.peakBytes += stats->peakBytes;
+    }
+
+    int64_t reserved = 0, requested = 0;
+    for(int i = 0; i < POOL_CLASS_COUNT; i ++) {
+        reserved += total.classes[i].blocksReserved * total.classes[i].blockSize;
+        requested += total.classes[i].bytesInUse;
+    }
+    total.fragmentation = reserved > 0 ? 1.0f - (float)requested / (float)reserved : 0.0f;
+
+    return total;
+}
+
+void PrintPoolStats(void) {
+    PoolStats stats = GetPoolStats();
+
+    printf("%8s %10s %10s %10s %12s %12s\n", "class", "allocs", "in use", "reserved", "bytes", "peak");
+    for(int i = 0; i < POOL_CLASS_COUNT; i ++) {
+        PoolClassStats * cs = &stats.classes[i];
+        printf("%8d %10lld %10lld %10lld %12lld %12lld\n", cs->blockSize, (long long)cs->allocs,
+            (long long)cs->blocksInUse, (long long)cs->blocksReserved, (long long)cs->bytesInUse, (long long)cs->peakBytes);
+    }
+    printf("%8s %10lld %10s %10s %12lld %12lld\n", "large", (long long)stats.largeAllocs, "", "",
+        (long long)stats.largeBytesInUse, (long long)stats.largePeakBytes);
+    printf("in use %lld bytes, peak %lld, chunks %lld, fragmentation %.1f%%\n", (long long)stats.bytesInUse,
+        (long long)stats.peakBytes, (long long)stats.chunkBytes, stats.fragmentation * 100.0f);
+}
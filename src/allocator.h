@@ -0,0 +1,52 @@
+#ifndef _allocator
+#define _allocator
+
+#include "headers.h"
+
+// size-classed pools behind the flecs os api, so ECS churn doesn't go through the global malloc lock.
+// each thread carves blocks out of its own chunks and keeps its own free lists
+
+#define POOL_CLASS_COUNT 9              // 16, 32, ... 4096 bytes
+#define POOL_MIN_SIZE 16
+#define POOL_MAX_SIZE (POOL_MIN_SIZE << (POOL_CLASS_COUNT - 1))
+#define POOL_CHUNK_SIZE (64 * 1024)
+#define POOL_HEADER_SIZE 16             // keeps blocks 16 byte aligned
+#define POOL_MAX_THREADS 64             // threads alive at once, any past that use plain malloc
+#define POOL_UNPOOLED -2                // sizeClass of those blocks
+
+typedef struct PoolClassStats {
+    int32_t blockSize;
+    int64_t allocs;             // total, ever
+    int64_t blocksInUse;
+    int64_t blocksReserved;     // carved out of chunks, in use or on a free list
+    int64_t bytesInUse;         // what callers asked for, not block size
+    int64_t peakBytes;
+} PoolClassStats;
+
+typedef struct PoolStats {
+    PoolClassStats classes[POOL_CLASS_COUNT];
+    int64_t largeAllocs;        // too big for a class, straight to malloc
+    int64_t largeBytesInUse;
+    int64_t largePeakBytes;
+    int64_t chunkBytes;
+    int64_t bytesInUse;
+    int64_t peakBytes;          // summed over threads, so an upper bound
+    float fragmentation;        // share of reserved block bytes not holding requested data
+} PoolStats;
+
+void InstallPoolAllocator(void);
+
+void * PoolMalloc(ecs_size_t size);
+void * PoolCalloc(ecs_size_t size);
+void * PoolRealloc(void * ptr, ecs_size_t size);
+void PoolFree(void * ptr);
+
+// the pools keep their chunks until this, after ecs_fini and after the other threads have stopped.
+// every chunk goes back to the system, along with anything still allocated from one
+void FreePoolAllocator(void);
+
+// reads other threads' counters without locking, so it's approximate while workers are running
+PoolStats GetPoolStats(void);
+void PrintPoolStats(void);
+
+#endif
@@ -0,0 +1,126 @@
+#include "arena.h"
+#include "headers.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int64_t gameHeapAllocs = 0;
+
+THREAD_LOCAL Arena frameArena = { 0 };
+
+Arena ArenaCreate(size_t size) {
+    Arena arena = { 0 };
+    arena.base = HEAP_ALLOC(MEMORY_ARENAS, size);
+    arena.size = size;
+    return arena;
+}
+
+static void FreeOverflow(Arena * arena) {
+    while(arena->overflow != NULL) {
+        void * next = *(void **)arena->overflow;
+        HEAP_FREE(arena->overflow);
+        arena->overflow = next;
+    }
+    arena->overflowBytes = 0;
+}
+
+void ArenaDestroy(Arena * arena) {
+    FreeOverflow(arena);
+    HEAP_FREE(arena->base);
+    *arena = (Arena){ 0 };
+}
+
+// a heap block for what didn't fit, ARENA_ALIGN in front of it for the chain
+static void * ArenaOverflow(Arena * arena, size_t size) {
+    if(arena->overflow == NULL)
+        printf("ARENA: out of its %zu bytes, %zu more from the heap until the next reset grows it\n", arena->size, size);
+
+    char * block = HEAP_ALLOC(MEMORY_ARENAS, ARENA_ALIGN + size);
+    if(block == NULL) {
+        printf("ARENA: couldn't get %zu bytes\n", size);
+        abort();
+    }
+    *(void **)block = arena->overflow;
+    arena->overflow = block;
+    arena->overflowBytes += ARENA_ALIGN + size;
+    if(arena->used + arena->overflowBytes > arena->peak)
+        arena->peak = arena->used + arena->overflowBytes;
+    return block + ARENA_ALIGN;
+}
+
+void * ArenaAlloc(Arena * arena, size_t size) {
+    size_t start = (arena->used + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1);
+    if(size > arena->size || start > arena->size - size)
+        return ArenaOverflow(arena, size);
+
+    arena->used = start + size;
+    if(arena->used + arena->overflowBytes > arena->peak)
+        arena->peak = arena->used + arena->overflowBytes;
+
+    return arena->base + start;
+}
+
+void ArenaReset(Arena * arena) {
+    bool grow = arena->overflow != NULL;
+    FreeOverflow(arena);
+    arena->used = 0;
+
+    // nothing points into it now, so it can move
+    if(grow) {
+        size_t size = arena->size * 2 > arena->peak ? arena->size * 2 : arena->peak;
+        HEAP_FREE(arena->base);
+        *arena = (Arena){ .base = HEAP_ALLOC(MEMORY_ARENAS, size), .size = size, .peak = arena->peak };
+        if(arena->base == NULL) {
+            printf("ARENA: couldn't grow to %zu bytes\n", size);
+            abort();
+        }
+    }
+}
+
+Arena * FrameArena(void) {
+    if(frameArena.base == NULL)
+        frameArena = ArenaCreate(FRAME_ARENA_SIZE);
+    return &frameArena;
+}
+
+void FrameArenaReset(void) {
+    ArenaReset(FrameArena());
+}
+
+void CountHeapAlloc(void) {
+#ifdef _MSC_VER
+    _InterlockedIncrement64(&gameHeapAllocs);
+#else
+    __atomic_add_fetch(&gameHeapAllocs, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+// ours plus everything flecs asked its os api for
+int64_t HeapAllocCount(void) {
+#ifdef _MSC_VER
+    int64_t game = _InterlockedOr64(&gameHeapAllocs, 0);
+#else
+    int64_t game = __atomic_load_n(&gameHeapAllocs, __ATOMIC_RELAXED);
+#endif
+    return game + ecs_os_api_malloc_count + ecs_os_api_calloc_count + ecs_os_api_realloc_count;
+}
+
+// call once per frame. past warmup, any allocation is something the arena should have covered
+void ReportFrameHeapAllocs(void) {
+    static int64_t lastCount = 0;
+    static int frame = 0;
+
+    int64_t count = HeapAllocCount();
+    int64_t allocs = count - lastCount;
+    lastCount = count;
+
+    if(frame < FRAME_ALLOC_WARMUP) {
+        frame ++;
+        return;
+    }
+
+    if(allocs > 0) {
+        printf("HEAP ALLOCS THIS FRAME: %lld (arena peak %zu)\n", (long long)allocs, FrameArena()->peak);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef _arena
+#define _arena
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "memstats.h"
+
+// kept free of headers.h so boymath.h can use Arena
+
+#define FRAME_ARENA_SIZE (4 * 1024 * 1024)
+#define ARENA_ALIGN 16
+#define FRAME_ALLOC_WARMUP 60   // frames before a heap allocation counts as a leak in the steady state
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+// bump allocator. nothing is freed on its own, reset or rewind to a mark instead.
+// what doesn't fit goes into heap blocks kept until the next reset, which grows the arena to the peak
+typedef struct Arena {
+    char * base;
+    size_t size;
+    size_t used;
+    size_t peak;                // overflow included
+    void * overflow;            // the heap blocks, chained through their first bytes
+    size_t overflowBytes;
+} Arena;
+
+Arena ArenaCreate(size_t size);
+void ArenaDestroy(Arena * arena);
+void * ArenaAlloc(Arena * arena, size_t size);
+void ArenaReset(Arena * arena);
+
+// rewinding to 0 is a reset, so an outermost mark also frees the overflow and regrows
+#define ArenaMark(arena) ((arena)->used)
+#define ArenaRewind(arena, mark) ((mark) == 0 ? ArenaReset(arena) : (void)((arena)->used = (mark)))
+
+// one per thread, made on first use. the main thread resets its own at the end of the frame. flecs' workers
+// and the loader threads never do, theirs reset when their outermost ArenaRewind goes back to 0
+Arena * FrameArena(void);
+void FrameArenaReset(void);
+
+#define FRAME_ALLOC(T, count) ((T *)ArenaAlloc(FrameArena(), sizeof(T) * (count)))
+
+// malloc for game code, counted so the heap can be checked per frame, and tagged for memstats.c.
+// give it back with HEAP_FREE. workers allocate too, so the count is atomic
+void CountHeapAlloc(void);
+#define HEAP_ALLOC(tag, size) (CountHeapAlloc(), MemoryAlloc((tag), (size)))
+#define HEAP_FREE(ptr) MemoryFree(ptr)
+
+int64_t HeapAllocCount(void);
+void ReportFrameHeapAllocs(void);
+
+#endif
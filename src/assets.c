@@ -0,0 +1,210 @@
+#include "assets.h"
+
+#define HASH_CHUNK (64 * 1024)
+
+// FNV-1a over the file's bytes, 0 if it can't be read
+uint64_t HashFile(const char * path) {
+    FILE * file = fopen(path, "rb");
+    if(file == NULL)
+        return 0;
+
+    static THREAD_LOCAL unsigned char chunk[HASH_CHUNK];
+    uint64_t hash = 14695981039346656037ull;
+    size_t n;
+    while((n = fread(chunk, 1, HASH_CHUNK, file)) > 0) {
+        for(size_t i = 0; i < n; i ++) {
+            hash = (hash ^ chunk[i]) * 1099511628211ull;
+        }
+    }
+    fclose(file);
+    return hash;
+}
+
+static int CompareVector3(const void * a, const void * b) {
+    const Vector3 * u = a;
+    const Vector3 * v = b;
+    if(u->x != v->x)
+        return u->x < v->x ? -1 : 1;
+    if(u->y != v->y)
+        return u->y < v->y ? -1 : 1;
+    if(u->z != v->z)
+        return u->z < v->z ? -1 : 1;
+    return 0;
+}
+
+// every distinct position once. glbs come out of raylib unindexed, so each corner is there once per triangle
+int WeldVertices(const Vector3 * verts, int count, Vector3 * out) {
+    if(count == 0)
+        return 0;
+
+    memcpy(out, verts, sizeof(Vector3) * count);
+    qsort(out, count, sizeof(Vector3), CompareVector3);
+
+    int n = 1;
+    for(int i = 1; i < count; i ++) {
+        if(CompareVector3(&out[i], &out[n - 1]) != 0)
+            out[n ++] = out[i];
+    }
+    return n;
+}
+
+bool BakeAssetModel(const char * cachePath, Model model, uint64_t sourceHash) {
+    SnapshotBuffer buf = NEWVECTOR(uint8_t);
+
+    // patched at the end, once the offsets are known
+    AssetHeader header = { .magic = ASSET_MAGIC, .version = ASSET_VERSION, .sourceHash = sourceHash };
+    SnapshotWrite(&buf, &header, sizeof(header));
+    SnapshotWriteModel(&buf, model, NULL, &header.model);
+
+    // a bake is rare and a mesh can be bigger than the frame arena
+    BoundingBox * boxes = malloc(sizeof(BoundingBox) * model.meshCount);
+    AssetHull * hulls = calloc(model.meshCount, sizeof(AssetHull));
+    for(int i = 0; i < model.meshCount; i ++) {
+        Mesh mesh = model.meshes[i];
+        boxes[i] = GetMeshBoundingBox(mesh);
+
+        Vector3 * welded = malloc(sizeof(Vector3) * (mesh.vertexCount > 0 ? mesh.vertexCount : 1));
+        hulls[i].count = WeldVertices((Vector3 *)mesh.vertices, mesh.vertexCount, welded);
+        hulls[i].verts = SnapshotWrite(&buf, welded, sizeof(Vector3) * hulls[i].count);
+        free(welded);
+    }
+    header.boxes = SnapshotWrite(&buf, boxes, sizeof(BoundingBox) * model.meshCount);
+    header.hulls = SnapshotWrite(&buf, hulls, sizeof(AssetHull) * model.meshCount);
+    free(boxes);
+    free(hulls);
+
+    header.size = buf.size;
+    memcpy(VECTOR_DATA(buf), &header, sizeof(header));
+
+    bool ok = WriteSnapshotBuffer(cachePath, &buf);
+    FREEVECTOR(buf);
+    return ok;
+}
+
+// like SnapshotValid, everything the model and colliders will index into is inside the file
+static bool AssetValid(const MappedFile * file, uint64_t sourceHash) {
+    const AssetHeader * header = file->data;
+    if(file->size < sizeof(AssetHeader) || header->magic != ASSET_MAGIC || header->version != ASSET_VERSION ||
+        header->size != file->size || header->sourceHash != sourceHash)
+        return false;
+
+    int meshCount = header->model.meshCount;
+    if(!SnapshotModelValid(file->data, file->size, header->model) ||
+        !SnapshotInFile(file->size, header->boxes, meshCount, sizeof(BoundingBox)) ||
+        !SnapshotInFile(file->size, header->hulls, meshCount, sizeof(AssetHull)))
+        return false;
+
+    const AssetHull * hulls = SNAPSHOT_PTR(file->data, header->hulls);
+    for(int i = 0; i < meshCount; i ++) {
+        if(!SnapshotInFile(file->size, hulls[i].verts, hulls[i].count, sizeof(Vector3)))
+            return false;
+    }
+    return true;
+}
+
+// the cpu half of OpenAssetModel
+static bool MapAssetModel(const char * cachePath, uint64_t sourceHash, AssetModel * asset) {
+    *asset = (AssetModel){ 0 };
+    if(!MapFile(cachePath, &asset->file))
+        return false;
+
+    if(!AssetValid(&asset->file, sourceHash)) {
+        UnmapFile(&asset->file);
+        return false;
+    }
+
+    const AssetHeader * header = asset->file.data;
+    void * base = asset->file.data;
+    asset->model = SnapshotPrepareModel(base, header->model);
+    asset->boxes = SNAPSHOT_PTR(base, header->boxes);
+    asset->hulls = SNAPSHOT_PTR(base, header->hulls);
+    return true;
+}
+
+bool OpenAssetModel(const char * cachePath, uint64_t sourceHash, AssetModel * asset) {
+    if(!MapAssetModel(cachePath, sourceHash, asset))
+        return false;
+
+    for(int part = 0; part < AssetModelParts(asset); part ++) {
+        UploadAssetModelPart(asset, part);
+    }
+    return true;
+}
+
+int AssetModelParts(const AssetModel * asset) {
+    const AssetHeader * header = asset->file.data;
+    return header ? SnapshotModelParts(header->model) : 0;
+}
+
+void UploadAssetModelPart(AssetModel * asset, int part) {
+    const AssetHeader * header = asset->file.data;
+    SnapshotUploadModelPart(asset->file.data, header->model, &asset->model, part);
+}
+
+// cache/<file name without extension>-<hash>.asset. raylib's GetFileNameWithoutExt has one static buffer, so not that off the main thread
+static void AssetCachePath(char * out, size_t size, const char * path, uint64_t hash) {
+    const char * name = path;
+    for(const char * c = path; *c; c ++) {
+        if(*c == '/' || *c == '\\')
+            name = c + 1;
+    }
+    const char * dot = strrchr(name, '.');
+    int length = dot ? (int)(dot - name) : (int)strlen(name);
+    snprintf(out, size, "%s/%.*s-%016llx.asset", ASSET_CACHE_DIR, length, name, (unsigned long long)hash);
+}
+
+bool PrepareAssetModel(const char * path, AssetModel * asset) {
+    uint64_t hash = HashFile(path);
+    char cachePath[512];
+    AssetCachePath(cachePath, sizeof(cachePath), path, hash);
+    return MapAssetModel(cachePath, hash, asset);
+}
+
+AssetModel LoadAssetModel(const char * path) {
+    AssetModel asset = { 0 };
+    uint64_t hash = HashFile(path);
+
+    char cachePath[512];
+    AssetCachePath(cachePath, sizeof(cachePath), path, hash);
+    if(OpenAssetModel(cachePath, hash, &asset))
+        return asset;
+
+    // import, bake, then load the bake, so a miss hands back the same thing a hit does
+    printf("ASSET CACHE: baking %s\n", path);
+    Model model = LoadModel(path);
+    if(!DirectoryExists(ASSET_CACHE_DIR))
+        MakeDirectory(ASSET_CACHE_DIR);
+
+    if(model.meshCount > 0 && BakeAssetModel(cachePath, model, hash) && OpenAssetModel(cachePath, hash, &asset)) {
+        UnloadModel(model);
+        return asset;
+    }
+
+    printf("ASSET CACHE: couldn't cache %s, using it uncached\n", path);
+    asset.model = model;
+    return asset;
+}
+
+void UnloadAssetModel(AssetModel * asset) {
+    if(asset->file.data != NULL) {
+        UnloadSnapshotModel(asset->model);
+        UnmapFile(&asset->file);
+    }
+    else {
+        UnloadModel(asset->model);
+    }
+    *asset = (AssetModel){ 0 };
+}
+
+MeshCollider * GetAssetMeshCollidersArena(Arena * arena, const AssetModel * asset, Matrix transform) {
+    if(asset->boxes == NULL)
+        return GetModelMeshCollidersArena(arena, asset->model, transform);
+
+    MeshCollider * colliders = ArenaAlloc(arena, asset->model.meshCount * sizeof(MeshCollider));
+    for(int i = 0; i < asset->model.meshCount; i ++) {
+        BoundingBox box = asset->boxes[i];
+        const Vector3 * hull = SNAPSHOT_PTR(asset->file.data, asset->hulls[i].verts);
+        colliders[i] = (MeshCollider){ &asset->model.meshes[i], box, transform, TransformBoundingBox(box, transform), hull, asset->hulls[i].count };
+    }
+    return colliders;
+}
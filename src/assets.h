@@ -0,0 +1,58 @@
+#ifndef _assets
+#define _assets
+
+#include "headers.h"
+#include "collision.h"
+#include "snapshot.h"
+
+// processed models kept in ASSET_CACHE_DIR under a hash of the source file's bytes.
+// a hit maps the blob and uploads it, LoadModel and the collider prep only run when the source changes
+
+#define ASSET_CACHE_DIR "cache"
+#define ASSET_MAGIC 0x54455341         // "ASET"
+#define ASSET_VERSION 2
+
+typedef struct AssetHull {
+    int32_t count;
+    int32_t pad;
+    uint64_t verts;             // Vector3[count]
+} AssetHull;
+
+// SnapshotModel plus what the colliders want, all offsets from the start of the file
+typedef struct AssetHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;
+    uint64_t sourceHash;
+    SnapshotModel model;
+    uint64_t boxes;             // BoundingBox[meshCount], mesh space
+    uint64_t hulls;             // AssetHull[meshCount]
+} AssetHeader;
+
+typedef struct AssetModel {
+    Model model;
+    const BoundingBox * boxes;  // NULL when the cache couldn't be used and this is LoadModel's model
+    const AssetHull * hulls;
+    MappedFile file;
+} AssetModel;
+
+uint64_t HashFile(const char * path);
+int WeldVertices(const Vector3 * verts, int count, Vector3 * out);
+
+AssetModel LoadAssetModel(const char * path);
+void UnloadAssetModel(AssetModel * asset);
+
+// the two halves of LoadAssetModel, for tools
+bool BakeAssetModel(const char * cachePath, Model model, uint64_t sourceHash);
+bool OpenAssetModel(const char * cachePath, uint64_t sourceHash, AssetModel * asset);
+
+// LoadAssetModel split for loader.c. prepare is the hash and the mapping, fine on any thread, and false on a miss.
+// the parts are the gpu uploads, main thread only
+bool PrepareAssetModel(const char * path, AssetModel * asset);
+int AssetModelParts(const AssetModel * asset);
+void UploadAssetModelPart(AssetModel * asset, int part);
+
+// like GetModelMeshCollidersArena with the cached boxes and hulls
+MeshCollider * GetAssetMeshCollidersArena(Arena * arena, const AssetModel * asset, Matrix transform);
+
+#endif
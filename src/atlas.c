@@ -0,0 +1,111 @@
+#include "atlas.h"
+#include "rlgl.h"
+
+bool LoadAtlasRegions(const char * path, Atlas * atlas) {
+    atlas->regionCount = 0;
+    char * text = LoadFileText(path);
+    if(text == NULL)
+        return false;
+
+    int lineNumber = 0;
+    for(char * line = text; line != NULL && *line != '\0'; ) {
+        char * next = strchr(line, '\n');
+        if(next != NULL)
+            *next ++ = '\0';
+        lineNumber ++;
+
+        AtlasRegion region = { 0 };
+        int read = sscanf(line, " %31s %f %f %f %f", region.name, &region.rect.x, &region.rect.y, &region.rect.width, &region.rect.height);
+        if(read > 0 && region.name[0] != '#') {
+            if(read != 5)
+                printf("ATLAS: %s:%d: expected name x y width height\n", path, lineNumber);
+            else if(atlas->regionCount == ATLAS_MAX_REGIONS)
+                printf("ATLAS: %s: more than %d regions\n", path, ATLAS_MAX_REGIONS);
+            else
+                atlas->regions[atlas->regionCount ++] = region;
+        }
+        line = next;
+    }
+
+    UnloadFileText(text);
+    return true;
+}
+
+void UnloadAtlas(Atlas * atlas) {
+    // UnloadMaterial leaves the default texture alone
+    for(int i = 0; i < atlas->bindingCount; i ++) {
+        AtlasBinding b = atlas->bindings[i];
+        b.materials[b.material].maps[MATERIAL_MAP_DIFFUSE].texture =
+            (Texture2D){ rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    }
+    MemoryCount(MEMORY_TEXTURES, -TEXTURE_BYTES(atlas->texture));
+    UnloadTexture(atlas->texture);
+    *atlas = (Atlas){ 0 };
+}
+
+int FindAtlasRegion(const Atlas * atlas, const char * name) {
+    for(int i = 0; i < atlas->regionCount; i ++) {
+        if(strcmp(atlas->regions[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+Rectangle GetAtlasRegion(const Atlas * atlas, const char * name) {
+    int i = FindAtlasRegion(atlas, name);
+    if(i < 0) {
+        printf("ATLAS: no region %s\n", name);
+        return (Rectangle){ 0 };
+    }
+    return atlas->regions[i].rect;
+}
+
+void SetModelMaterialAtlas(Model * model, int material, Atlas * atlas, const char * region) {
+    Rectangle rect = GetAtlasRegion(atlas, region);
+    float w = (float)atlas->texture.width;
+    float h = (float)atlas->texture.height;
+    if(rect.width == 0 || w == 0 || h == 0)
+        return;
+
+    Vector2 offset = { rect.x / w, rect.y / h };
+    Vector2 scale = { rect.width / w, rect.height / h };
+
+    for(int i = 0; i < model->meshCount; i ++) {
+        int meshMaterial = model->meshMaterial ? model->meshMaterial[i] : 0;
+        Mesh * mesh = &model->meshes[i];
+        if(meshMaterial != material || mesh->texcoords == NULL)
+            continue;
+
+        Vector2 * uv = (Vector2 *)mesh->texcoords;
+        for(int v = 0; v < mesh->vertexCount; v ++) {
+            uv[v] = (Vector2){ offset.x + uv[v].x * scale.x, offset.y + uv[v].y * scale.y };
+        }
+        // 1 is raylib's texcoord buffer
+        if(mesh->vboId != NULL)
+            UpdateMeshBuffer(*mesh, 1, mesh->texcoords, mesh->vertexCount * 2 * sizeof(float), 0);
+    }
+
+    BindModelMaterialAtlas(model, material, atlas, region);
+}
+
+void BindModelMaterialAtlas(Model * model, int material, Atlas * atlas, const char * region) {
+    int r = FindAtlasRegion(atlas, region);
+    if(r < 0 || material >= model->materialCount)
+        return;
+    if(ModelMaterialAtlasRegion(atlas, model->materials, material) == NULL) {
+        if(atlas->bindingCount == ATLAS_MAX_BINDINGS) {
+            printf("ATLAS: more than %d materials bound\n", ATLAS_MAX_BINDINGS);
+            return;
+        }
+        atlas->bindings[atlas->bindingCount ++] = (AtlasBinding){ model->materials, material, r };
+    }
+    model->materials[material].maps[MATERIAL_MAP_DIFFUSE].texture = atlas->texture;
+}
+
+const char * ModelMaterialAtlasRegion(const Atlas * atlas, const Material * materials, int material) {
+    for(int i = 0; i < atlas->bindingCount; i ++) {
+        if(atlas->bindings[i].materials == materials && atlas->bindings[i].material == material)
+            return atlas->regions[atlas->bindings[i].region].name;
+    }
+    return NULL;
+}
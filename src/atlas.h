@@ -0,0 +1,51 @@
+#ifndef _atlas
+#define _atlas
+
+#include "headers.h"
+
+// one texture, named rectangles into it. the rectangles come from a sidecar next to the image, one per line:
+//   name x y width height      (pixels, # starts a comment)
+// so tiles are drawn as source rects or remapped uvs instead of being copied into their own images and textures
+
+#define ATLAS_MAX_REGIONS 64
+#define ATLAS_NAME_LENGTH 32
+#define ATLAS_MAX_BINDINGS 8
+
+typedef struct AtlasRegion {
+    char name[ATLAS_NAME_LENGTH];
+    Rectangle rect;
+} AtlasRegion;
+
+// a model material drawing out of the atlas. the texture is only lent, the atlas still owns it
+typedef struct AtlasBinding {
+    Material * materials;       // the model's array, every copy of the Model shares it
+    int material;
+    int region;
+} AtlasBinding;
+
+typedef struct Atlas {
+    Texture2D texture;          // may arrive after the regions, see loader.c
+    int regionCount;
+    AtlasRegion regions[ATLAS_MAX_REGIONS];
+    int bindingCount;
+    AtlasBinding bindings[ATLAS_MAX_BINDINGS];
+} Atlas;
+
+bool LoadAtlasRegions(const char * path, Atlas * atlas);
+// gives bound materials the default texture back first, so unload the atlas before the models it's bound to
+void UnloadAtlas(Atlas * atlas);
+
+// index into regions, -1 if there's no such name
+int FindAtlasRegion(const Atlas * atlas, const char * name);
+// the region's rect, a zero rect if missing
+Rectangle GetAtlasRegion(const Atlas * atlas, const char * name);
+
+// squeezes the uvs of every mesh drawn with material into region and binds the material to the atlas.
+// the uvs have to be in 0..1 and it's once per model, the cpu copies are rewritten in place
+void SetModelMaterialAtlas(Model * model, int material, Atlas * atlas, const char * region);
+// only the texture, for uvs that were squeezed already (a snapshot's)
+void BindModelMaterialAtlas(Model * model, int material, Atlas * atlas, const char * region);
+// the region a material is bound to, NULL if it isn't
+const char * ModelMaterialAtlasRegion(const Atlas * atlas, const Material * materials, int material);
+
+#endif
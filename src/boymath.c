@@ -11,7 +11,16 @@ Vector3 Vector3TripleProduct(Vector3 v0, Vector3 v1, Vector3 v2) {
 }
 
 Vector3 * Vector3ArrayTransform(Vector3 * in, int count, Matrix matTransform) {
-    Vector3 * out = (Vector3 *)malloc(sizeof(Vector3) * count);
+    Vector3 * out = (Vector3 *)HEAP_ALLOC(MEMORY_COLLIDERS, sizeof(Vector3) * count);
+    for(int i = 0; i < count; i ++) {
+        out[i] = Vector3Transform(in[i], matTransform);
+    }
+
+    return out;
+}
+
+Vector3 * Vector3ArrayTransformArena(Arena * arena, Vector3 * in, int count, Matrix matTransform) {
+    Vector3 * out = (Vector3 *)ArenaAlloc(arena, sizeof(Vector3) * count);
     for(int i = 0; i < count; i ++) {
         out[i] = Vector3Transform(in[i], matTransform);
     }
@@ -73,7 +82,9 @@ BoundingBox TransformBoundingBox(BoundingBox box, Matrix matTransform) {
 }
 
 Vector3 ClipVector(Vector3 vec, Vector3 normal) {
+#if DRAWWIRES
     DrawRay((Ray){ mouseWorld, normal }, YELLOW);
+#endif
 
     float backoff = Vector3DotProduct(vec, normal);
     Vector3 eject = Vector3Scale(normal, backoff);
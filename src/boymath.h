@@ -6,6 +6,7 @@
 float Vector3MixedProduct(Vector3 v0, Vector3 v1, Vector3 v2);
 Vector3 Vector3TripleProduct(Vector3 v0, Vector3 v1, Vector3 v2);
 Vector3 * Vector3ArrayTransform(Vector3 * in, int count, Matrix matTransform);
+Vector3 * Vector3ArrayTransformArena(Arena * arena, Vector3 * in, int count, Matrix matTransform);
 
 bool BoundingBoxIntersects(BoundingBox a, BoundingBox b);
 bool BoundingBoxContains(BoundingBox b, Vector3 point);
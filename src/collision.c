@@ -7,9 +7,11 @@ ecs_query_t * q_MeshCollider;
 ecs_query_t * q_BoxCollider;
 ecs_query_t * q_BoxColliderNotActor;
 
-void VertexMeshSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec) {
+ECS_COMPONENT_DECLARE(MeshCollider);
+ECS_COMPONENT_DECLARE(BoxCollider);
+
+Vector3 VertexMeshSupportPoint(const void *obj, Vector3 direction) {
     VertexMesh * meshPtr = (VertexMesh *)obj;
-    Vector3 direction = CCD_TO_RL_VEC3(dir->v);
 
     int best_index = 0;
     float best_match = Vector3DotProduct(direction, meshPtr->verts[0]);
@@ -23,124 +25,205 @@ void VertexMeshSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec)
 
     Vector3 support = meshPtr->verts[best_index];
     assert(!VECTOR3_IS_NAN(support));
+    return support;
+}
+
+void VertexMeshSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec) {
+    Vector3 support = VertexMeshSupportPoint(obj, CCD_TO_RL_VEC3(dir->v));
     *vec = RL_TO_CCD_VEC3(support);
 }
 
-Collision VertexMeshCollision(VertexMesh a, VertexMesh b) {
+// average of the verts, always inside the hull which is all MPR needs
+Vector3 VertexMeshCenter(const void *obj) {
+    VertexMesh * meshPtr = (VertexMesh *)obj;
+
+    Vector3 sum = Vector3Zero();
+    for(int i = 0; i < meshPtr->vertCount; i ++) {
+        sum = Vector3Add(sum, meshPtr->verts[i]);
+    }
+    return Vector3Scale(sum, 1.0f / meshPtr->vertCount);
+}
+
+// libccd's penetration test, kept as the reference the in-tree GJK is checked against
+Collision CCDPenetration(const void * obj1, ccd_support_fn support1, const void * obj2, ccd_support_fn support2) {
     ccd_t ccd;
     CCD_INIT(&ccd);
 
-    ccd.support1 = VertexMeshSupport;
-    ccd.support2 = VertexMeshSupport;
+    ccd.support1 = support1;
+    ccd.support2 = support2;
     ccd.max_iterations = 100;
 
     ccd_real_t depth = 0;
     ccd_vec3_t dir, pos;
-    int intersect = ccdGJKPenetration(&b, &a, &ccd, &depth, &dir, &pos);
+    COLLISION_COUNT(gjkCalls, 1);       // libccd doesn't say how many iterations it took
+    int intersect = ccdGJKPenetration(obj1, obj2, &ccd, &depth, &dir, &pos);
 
     return (Collision){ intersect == 0 && depth > 0, (float)depth, Vector3Normalize(CCD_TO_RL_VEC3(dir.v)), CCD_TO_RL_VEC3(pos.v) };
 }
 
+Collision VertexMeshCollision(VertexMesh a, VertexMesh b) {
+#if USE_LIBCCD
+    return CCDPenetration(&b, VertexMeshSupport, &a, VertexMeshSupport);
+#else
+    return VertexMeshVertexMeshPenetration(&b, &a);
+#endif
+}
+
 VertexMesh MeshToVertexMesh(Mesh mesh, Matrix matTransform) {
     VertexMesh vMesh = { 0 };
     vMesh.vertCount = mesh.vertexCount;
-    // receiver must free these
+    // receiver must HEAP_FREE these
     vMesh.verts = Vector3ArrayTransform((Vector3 *)mesh.vertices, mesh.vertexCount, matTransform);
     return vMesh;
 }
 
-Collision MeshCollision(MeshCollider a, MeshCollider b) {
-    Matrix atransform, btransform;
-    if(a.transform == NULL)
-        atransform = MatrixIdentity();
-    else
-        atransform = *a.transform;
-    if(b.transform == NULL)
-        btransform = MatrixIdentity();
-    else
-        btransform = *b.transform;
-        
-    BoundingBox abox = TransformBoundingBox(a.box, atransform);
-    BoundingBox bbox = TransformBoundingBox(b.box, btransform);
+// verts live until the arena is rewound or reset
+VertexMesh MeshToVertexMeshArena(Arena * arena, Mesh mesh, Matrix matTransform) {
+    VertexMesh vMesh = { 0 };
+    vMesh.vertCount = mesh.vertexCount;
+    vMesh.verts = Vector3ArrayTransformArena(arena, (Vector3 *)mesh.vertices, mesh.vertexCount, matTransform);
+    return vMesh;
+}
 
-    if(!BoundingBoxIntersects(abox, bbox)) {
+// the welded hull when there is one, same convex shape from a fraction of the points
+VertexMesh MeshColliderToVertexMeshArena(Arena * arena, MeshCollider m) {
+    if(m.hull == NULL)
+        return MeshToVertexMeshArena(arena, *m.mesh, m.transform);
+
+    VertexMesh vMesh = { 0 };
+    vMesh.vertCount = m.hullCount;
+    vMesh.verts = Vector3ArrayTransformArena(arena, (Vector3 *)m.hull, m.hullCount, m.transform);
+    return vMesh;
+}
+
+Collision MeshCollision(MeshCollider a, MeshCollider b) {
+    COLLISION_COUNT(aabbTests, 1);
+    if(!BoundingBoxIntersects(a.worldBox, b.worldBox)) {
+        COLLISION_COUNT(aabbRejects, 1);
         return (Collision){ false };
     }
 
-    VertexMesh va = MeshToVertexMesh(*a.mesh, atransform);
-    VertexMesh vb = MeshToVertexMesh(*b.mesh, btransform);
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+
+    VertexMesh va = MeshColliderToVertexMeshArena(arena, a);
+    VertexMesh vb = MeshColliderToVertexMeshArena(arena, b);
 
     Collision c = VertexMeshCollision(va, vb);
-    free(va.verts);
-    free(vb.verts);
+    ArenaRewind(arena, mark);
 
     return c;
 }
 
-MeshCollider * GetModelMeshColliders(Model model, Matrix * transform) {
-    MeshCollider * colliders = malloc(model.meshCount * sizeof(MeshCollider));
+MeshCollider MakeMeshCollider(Mesh * mesh, Matrix transform) {
+    BoundingBox box = GetMeshBoundingBox(*mesh);
+    return (MeshCollider){ mesh, box, transform, TransformBoundingBox(box, transform) };
+}
+
+MeshCollider * GetModelMeshColliders(Model model, Matrix transform) {
+    MeshCollider * colliders = HEAP_ALLOC(MEMORY_COLLIDERS, model.meshCount * sizeof(MeshCollider));
+    for(int i = 0; i < model.meshCount; i ++) {
+        colliders[i] = MakeMeshCollider(&model.meshes[i], transform);
+    }
+    return colliders;
+}
+
+MeshCollider * GetModelMeshCollidersArena(Arena * arena, Model model, Matrix transform) {
+    MeshCollider * colliders = ArenaAlloc(arena, model.meshCount * sizeof(MeshCollider));
     for(int i = 0; i < model.meshCount; i ++) {
-        colliders[i] = (MeshCollider){ &model.meshes[i], GetMeshBoundingBox(model.meshes[i]), transform };
+        colliders[i] = MakeMeshCollider(&model.meshes[i], transform);
     }
     return colliders;
 }
 
-MeshCollider GetModelMeshCollider0(Model model, Matrix * transform) {
-    return (MeshCollider){ &model.meshes[0], GetMeshBoundingBox(model.meshes[0]), transform };
+MeshCollider GetModelMeshCollider0(Model model, Matrix transform) {
+    return MakeMeshCollider(&model.meshes[0], transform);
 }
 
-void PointSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec) {
+// system: pick up the entity's Matrix and refresh the world box, only for tables whose Matrix changed
+void UpdateMeshColliderBounds(ecs_iter_t * it) {
+    if(!ecs_iter_changed(it)) {
+        ecs_iter_skip(it);
+        return;
+    }
+
+    MeshCollider * colliders = ecs_field(it, MeshCollider, 0);
+    const Matrix * transforms = ecs_field(it, Matrix, 1);
+
+    for(int i = 0; i < it->count; i ++) {
+        colliders[i].transform = transforms[i];
+        colliders[i].worldBox = TransformBoundingBox(colliders[i].box, transforms[i]);
+    }
+}
+
+Vector3 PointSupportPoint(const void *obj, Vector3 direction) {
     Vector3 * pointPTR = (Vector3 *)obj;
 
     assert(!VECTOR3_PTR_IS_NAN(pointPTR));
 
-    *vec = RL_PTR_TO_CCD_VEC3(pointPTR);
+    return *pointPTR;
 }
 
-Collision PointVertexMeshCollision(Vector3 p, VertexMesh vm) {
-    ccd_t ccd;
-    CCD_INIT(&ccd);
+void PointSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec) {
+    Vector3 * pointPTR = (Vector3 *)obj;
 
-    ccd.support1 = VertexMeshSupport;
-    ccd.support2 = PointSupport;
-    ccd.max_iterations = 100;
+    assert(!VECTOR3_PTR_IS_NAN(pointPTR));
 
-    ccd_real_t depth = 0;
-    ccd_vec3_t dir, pos;
-    int intersect = ccdGJKPenetration(&vm, &p, &ccd, &depth, &dir, &pos);
+    *vec = RL_PTR_TO_CCD_VEC3(pointPTR);
+}
 
-    return (Collision){ intersect == 0 && depth > 0, (float)depth, Vector3Normalize(CCD_TO_RL_VEC3(dir.v)), CCD_TO_RL_VEC3(pos.v) };
+Vector3 PointCenter(const void *obj) {
+    return *(Vector3 *)obj;
+}
+
+Collision PointVertexMeshCollision(Vector3 p, VertexMesh vm, CollisionTier tier) {
+#if USE_LIBCCD
+    // reference path, always exact
+    return CCDPenetration(&vm, VertexMeshSupport, &p, PointSupport);
+#else
+    switch(tier) {
+        case COLLISION_INTERSECT:
+            return (Collision){ VertexMeshPointIntersect(&vm, &p) };
+        case COLLISION_ESTIMATE:
+            return VertexMeshPointPenetrationMPR(&vm, &p);
+        default:
+            return VertexMeshPointPenetration(&vm, &p);
+    }
+#endif
 }
 
 Collision PointMeshCollision(Vector3 p, MeshCollider m) {
-    Matrix mtransform;
-    if(m.transform == NULL)
-        mtransform = MatrixIdentity();
-    else
-        mtransform = *m.transform;
-        
-    BoundingBox mbox = TransformBoundingBox(m.box, mtransform);
+    return PointMeshCollisionTier(p, m, COLLISION_EXACT);
+}
+
+bool PointMeshIntersect(Vector3 p, MeshCollider m) {
+    return PointMeshCollisionTier(p, m, COLLISION_INTERSECT).hit;
+}
 
-    if(!BoundingBoxContains(mbox, p)) {
+Collision PointMeshCollisionTier(Vector3 p, MeshCollider m, CollisionTier tier) {
+    COLLISION_COUNT(aabbTests, 1);
+    if(!BoundingBoxContains(m.worldBox, p)) {
+        COLLISION_COUNT(aabbRejects, 1);
         return (Collision){ false };
     }
 
-    VertexMesh vm = MeshToVertexMesh(*m.mesh, mtransform);
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+    VertexMesh vm = MeshColliderToVertexMeshArena(arena, m);
 
-    Collision c = PointVertexMeshCollision(p, vm);
+    Collision c = PointVertexMeshCollision(p, vm, tier);
 
-    free(vm.verts);
+    ArenaRewind(arena, mark);
 
     //if(c.hit)
-    //    DrawBoundingBox(mbox, PURPLE);
+    //    DrawBoundingBox(m.worldBox, PURPLE);
 
     return c;
 }
 
-void BoundingBoxSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec) {
+Vector3 BoundingBoxSupportPoint(const void *obj, Vector3 direction) {
     BoundingBox * bboxPTR = (BoundingBox *)obj;
 
-    Vector3 direction = CCD_TO_RL_VEC3(dir->v);
     Vector3 dirSign = VECTOR3SIGN(direction);
 
     Vector3 halfsize = Vector3Scale(Vector3Subtract(bboxPTR->max, bboxPTR->min), 0.5f);
@@ -149,92 +232,149 @@ void BoundingBoxSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec)
     Vector3 support = Vector3Add(center, Vector3Multiply(dirSign, halfsize));
 
     assert(!VECTOR3_IS_NAN(support));
-    *vec = RL_TO_CCD_VEC3(support);
+    return support;
 }
 
-Collision BoxVertexMeshCollision(BoundingBox box, VertexMesh vm) {
-    ccd_t ccd;
-    CCD_INIT(&ccd);
-
-    ccd.support1 = VertexMeshSupport;
-    ccd.support2 = BoundingBoxSupport;
-    ccd.max_iterations = 100;
+void BoundingBoxSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec) {
+    Vector3 support = BoundingBoxSupportPoint(obj, CCD_TO_RL_VEC3(dir->v));
+    *vec = RL_TO_CCD_VEC3(support);
+}
 
-    ccd_real_t depth = 0;
-    ccd_vec3_t dir, pos;
-    int intersect = ccdGJKPenetration(&vm, &box, &ccd, &depth, &dir, &pos);
+Vector3 BoundingBoxCenter(const void *obj) {
+    BoundingBox * bboxPTR = (BoundingBox *)obj;
+    return Vector3Scale(Vector3Add(bboxPTR->min, bboxPTR->max), 0.5f);
+}
 
-    return (Collision){ intersect == 0 && depth > 0, (float)depth, Vector3Normalize(CCD_TO_RL_VEC3(dir.v)), CCD_TO_RL_VEC3(pos.v) };
+// in-tree GJK/EPA, one copy per pair of shapes so the supports inline
+GJK_PENETRATION(VertexMeshVertexMeshPenetration, VertexMeshSupportPoint, VertexMeshSupportPoint)
+GJK_PENETRATION(VertexMeshPointPenetration, VertexMeshSupportPoint, PointSupportPoint)
+GJK_PENETRATION(VertexMeshBoxPenetration, VertexMeshSupportPoint, BoundingBoxSupportPoint)
+GJK_PENETRATION(BoxBoxPenetration, BoundingBoxSupportPoint, BoundingBoxSupportPoint)
+GJK_PENETRATION(BoxPointPenetration, BoundingBoxSupportPoint, PointSupportPoint)
+
+// cheaper tiers for callers that don't need the minimum translation
+MPR_PENETRATION(VertexMeshPointPenetrationMPR, VertexMeshSupportPoint, VertexMeshCenter, PointSupportPoint, PointCenter)
+MPR_PENETRATION(VertexMeshBoxPenetrationMPR, VertexMeshSupportPoint, VertexMeshCenter, BoundingBoxSupportPoint, BoundingBoxCenter)
+GJK_INTERSECT(VertexMeshPointIntersect, VertexMeshSupportPoint, PointSupportPoint)
+GJK_INTERSECT(VertexMeshBoxIntersect, VertexMeshSupportPoint, BoundingBoxSupportPoint)
+
+Collision BoxVertexMeshCollision(BoundingBox box, VertexMesh vm, CollisionTier tier) {
+#if USE_LIBCCD
+    // reference path, always exact
+    return CCDPenetration(&vm, VertexMeshSupport, &box, BoundingBoxSupport);
+#else
+    switch(tier) {
+        case COLLISION_INTERSECT:
+            return (Collision){ VertexMeshBoxIntersect(&vm, &box) };
+        case COLLISION_ESTIMATE:
+            return VertexMeshBoxPenetrationMPR(&vm, &box);
+        default:
+            return VertexMeshBoxPenetration(&vm, &box);
+    }
+#endif
 }
 
 Collision BoxMeshCollision(BoundingBox box, MeshCollider m) {
-    Matrix mtransform;
-    if(m.transform == NULL)
-        mtransform = MatrixIdentity();
-    else
-        mtransform = *m.transform;
-        
-    BoundingBox mbox = TransformBoundingBox(m.box, mtransform);
+    return BoxMeshCollisionTier(box, m, COLLISION_EXACT);
+}
+
+bool BoxMeshIntersect(BoundingBox box, MeshCollider m) {
+    return BoxMeshCollisionTier(box, m, COLLISION_INTERSECT).hit;
+}
 
-    if(!BoundingBoxIntersects(box, mbox)) {
+Collision BoxMeshCollisionTier(BoundingBox box, MeshCollider m, CollisionTier tier) {
+    COLLISION_COUNT(aabbTests, 1);
+    if(!BoundingBoxIntersects(box, m.worldBox)) {
+        COLLISION_COUNT(aabbRejects, 1);
         return (Collision){ false };
     }
 
-    VertexMesh vm = MeshToVertexMesh(*m.mesh, mtransform);
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+    VertexMesh vm = MeshColliderToVertexMeshArena(arena, m);
 
-    Collision c = BoxVertexMeshCollision(box, vm);
+    Collision c = BoxVertexMeshCollision(box, vm, tier);
 
-    free(vm.verts);
+    ArenaRewind(arena, mark);
 
 #if DEBUG
     if(c.hit)
-        DrawBoundingBox(mbox, PURPLE);
+        DrawBoundingBox(m.worldBox, PURPLE);
 #endif
     return c;
 }
 
 Collision BoxBoxCollision(BoundingBox b1, BoundingBox b2) {
 
+    COLLISION_COUNT(aabbTests, 1);
     if(!BoundingBoxIntersects(b1, b2)) {
+        COLLISION_COUNT(aabbRejects, 1);
         return (Collision){ false };
     }
 
-    ccd_t ccd;
-    CCD_INIT(&ccd);
-
-    ccd.support1 = BoundingBoxSupport;
-    ccd.support2 = BoundingBoxSupport;
-    ccd.max_iterations = 100;
-
-    ccd_real_t depth = 0;
-    ccd_vec3_t dir, pos;
-    int intersect = ccdGJKPenetration(&b2, &b1, &ccd, &depth, &dir, &pos);
+#if USE_LIBCCD
+    Collision c = CCDPenetration(&b2, BoundingBoxSupport, &b1, BoundingBoxSupport);
+#else
+    Collision c = BoxBoxPenetration(&b2, &b1);
+#endif
 
     assert(false);
 
-    return (Collision){ intersect == 0 && depth > 0, (float)depth, Vector3Normalize(CCD_TO_RL_VEC3(dir.v)), CCD_TO_RL_VEC3(pos.v) };
+    return c;
 }
 
 Collision PointBoxCollision(Vector3 p, BoundingBox box) {
 
+    COLLISION_COUNT(aabbTests, 1);
     if(!BoundingBoxContains(box, p)) {
+        COLLISION_COUNT(aabbRejects, 1);
         return (Collision){ false };
     }
 
-    ccd_t ccd;
-    CCD_INIT(&ccd);
+#if USE_LIBCCD
+    Collision c = CCDPenetration(&box, BoundingBoxSupport, &p, PointSupport);
+#else
+    Collision c = BoxPointPenetration(&box, &p);
+#endif
 
-    ccd.support1 = BoundingBoxSupport;
-    ccd.support2 = PointSupport;
-    ccd.max_iterations = 100;
+    assert(false);
 
-    ccd_real_t depth = 0;
-    ccd_vec3_t dir, pos;
-    int intersect = ccdGJKPenetration(&box, &p, &ccd, &depth, &dir, &pos);
+    return c;
+}
 
-    assert(false);
+// box covering everything a box passes through on its way along move
+BoundingBox SweptBoundingBox(BoundingBox box, Vector3 move) {
+    BoundingBox target = BoundingBoxAdd(box, move);
+    return (BoundingBox){ Vector3Min(box.min, target.min), Vector3Max(box.max, target.max) };
+}
 
-    return (Collision){ intersect == 0 && depth > 0, (float)depth, Vector3Normalize(CCD_TO_RL_VEC3(dir.v)), CCD_TO_RL_VEC3(pos.v) };
+TimeOfImpact BoxMeshSweep(BoundingBox box, Vector3 move, MeshCollider m) {
+    COLLISION_COUNT(aabbTests, 1);
+    if(!BoundingBoxIntersects(SweptBoundingBox(box, move), m.worldBox)) {
+        COLLISION_COUNT(aabbRejects, 1);
+        return (TimeOfImpact){ false };
+    }
+
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+    VertexMesh vm = MeshColliderToVertexMeshArena(arena, m);
+
+    TimeOfImpact t = GJKRaycast(&box, BoundingBoxSupportPoint, &vm, VertexMeshSupportPoint, move);
+
+    ArenaRewind(arena, mark);
+
+    return t;
+}
+
+TimeOfImpact BoxBoxSweep(BoundingBox box, Vector3 move, BoundingBox other) {
+
+    COLLISION_COUNT(aabbTests, 1);
+    if(!BoundingBoxIntersects(SweptBoundingBox(box, move), other)) {
+        COLLISION_COUNT(aabbRejects, 1);
+        return (TimeOfImpact){ false };
+    }
+
+    return GJKRaycast(&box, BoundingBoxSupportPoint, &other, BoundingBoxSupportPoint, move);
 }
 
 RayCollision RayToMeshColliders(Ray ray, float distance) {
@@ -249,14 +389,15 @@ RayCollision RayToMeshColliders(Ray ray, float distance) {
 
         for(int i = 0; i < it.count; i ++) {
             MeshCollider collider = colliders[i];
-            BoundingBox box = TransformBoundingBox(collider.box, *collider.transform);
 
-            RayCollision boxHitInfo = GetRayCollisionBox(ray, box);
+            RayCollision boxHitInfo = GetRayCollisionBox(ray, collider.worldBox);
+            COLLISION_COUNT(rayBoxTests, 1);
             if ((boxHitInfo.hit)) {
                 // Check ray collision against model meshes
                 RayCollision meshHitInfo = { 0 };
+                COLLISION_COUNT(rayMeshTests, 1);
 
-                meshHitInfo = GetRayCollisionMesh(ray, *collider.mesh, *collider.transform);
+                meshHitInfo = GetRayCollisionMesh(ray, *collider.mesh, collider.transform);
                 float hitAngle = Vector3Angle(ray.direction, meshHitInfo.normal)*RAD2DEG;
 
                 if (meshHitInfo.hit && hitAngle >= 90.0f && (meshHitInfo.distance < collision.distance) && (meshHitInfo.distance < distance))
@@ -284,6 +425,7 @@ RayCollision RayToBoxColliders(Ray ray, float distance) {
             BoxCollider box = colliders[i];
 
             RayCollision boxHitInfo = GetRayCollisionBox(ray, box);
+            COLLISION_COUNT(rayBoxTests, 1);
             if (boxHitInfo.hit && boxHitInfo.distance < collision.distance && boxHitInfo.distance < distance) {
                 collision = boxHitInfo;
             }
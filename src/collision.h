@@ -3,6 +3,7 @@
 
 #include "headers.h"
 #include "main.h"
+#include "gjk.h"
 
 extern ecs_query_t * q_MeshCollider;
 extern ecs_query_t * q_BoxCollider;
@@ -10,29 +11,43 @@ extern ecs_query_t * q_BoxColliderNotActor;
 extern ecs_query_t * q_ColliderNotActor;
 
 #define ECS_COLLIDER_COMPONENTS() \
-ECS_COMPONENT(world, MeshCollider); \
-ECS_COMPONENT(world, BoxCollider)
+ECS_COMPONENT_DEFINE(world, MeshCollider); \
+ECS_COMPONENT_DEFINE(world, BoxCollider)
 
+// needs AssetPending registered
 #define ECS_COLLIDER_QUERIES() \
 q_MeshCollider = ecs_query(world, { \
     .terms = { \
-        { ecs_id(MeshCollider) } \
+        { ecs_id(MeshCollider) }, { AssetPending, .oper = EcsNot } \
     }, \
     .cache_kind = EcsQueryCacheAll, \
 }); \
 q_BoxCollider = ecs_query(world, { \
     .terms = { \
-        { ecs_id(BoxCollider) } \
+        { ecs_id(BoxCollider) }, { AssetPending, .oper = EcsNot } \
     }, \
     .cache_kind = EcsQueryCacheAll, \
 }); \
 q_BoxColliderNotActor = ecs_query(world, { \
     .terms = { \
-        { ecs_id(BoxCollider) }, { ecs_id(Actor), .oper = EcsNot } \
+        { ecs_id(BoxCollider) }, { ecs_id(ActorType), .oper = EcsNot }, { AssetPending, .oper = EcsNot } \
     }, \
     .cache_kind = EcsQueryCacheAll, \
 })
 
+// needs Matrix registered. colliders without a Matrix keep the transform they were made with
+#define ECS_COLLIDER_SYSTEMS() \
+ecs_system(world, { \
+    .entity = ecs_entity(world, { .name = "UpdateMeshColliderBounds", .add = ecs_ids(ecs_dependson(EcsPreUpdate)) }), \
+    .query = { \
+        .terms = { \
+            { ecs_id(MeshCollider) }, { ecs_id(Matrix), .inout = EcsIn } \
+        }, \
+        .flags = EcsQueryDetectChanges, \
+    }, \
+    .callback = UpdateMeshColliderBounds, \
+})
+
 
 #define CCD_TO_RL_VEC3(vec) (Vector3){ (float)vec[0], (float)vec[1], (float)vec[2] }
 #define RL_TO_CCD_VEC3(vec) ((ccd_vec3_t){ (ccd_real_t)vec.x, (ccd_real_t)vec.y, (ccd_real_t)vec.z })
@@ -43,35 +58,74 @@ typedef struct VertexMesh {
     int vertCount;
 } VertexMesh;
 
-typedef struct Collision {
-    bool hit;
-    float depth;
-    Vector3 direction;
-    Vector3 point;
-} Collision;
-
 typedef struct MeshCollider {
     Mesh * mesh;
-    BoundingBox box;
-    Matrix * transform;
+    BoundingBox box;            // mesh space
+    Matrix transform;           // copy of the entity's Matrix, kept up to date by UpdateMeshColliderBounds
+    BoundingBox worldBox;       // box under transform, what every query checks first
+    const Vector3 * hull;       // mesh space, the mesh's vertices welded. NULL to use the mesh's own
+    int hullCount;
 } MeshCollider;
 
 // for component system
 typedef BoundingBox BoxCollider;
 typedef Vector3 PointCollider;
 
+extern ECS_COMPONENT_DECLARE(MeshCollider);
+extern ECS_COMPONENT_DECLARE(BoxCollider);
+
+// how much of an answer a collision query has to give, cheapest first
+typedef enum CollisionTier {
+    COLLISION_INTERSECT,    // hit only, GJK without EPA
+    COLLISION_ESTIMATE,     // depth and direction from MPR, along the line between centers so it can overshoot
+    COLLISION_EXACT,        // minimum translation from GJK + EPA
+} CollisionTier;
+
+Vector3 VertexMeshSupportPoint(const void *obj, Vector3 direction);
+Vector3 BoundingBoxSupportPoint(const void *obj, Vector3 direction);
+Vector3 PointSupportPoint(const void *obj, Vector3 direction);
 void VertexMeshSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec);
+void BoundingBoxSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec);
+void PointSupport(const void *obj, const ccd_vec3_t *dir, ccd_vec3_t *vec);
+Vector3 VertexMeshCenter(const void *obj);
+Vector3 BoundingBoxCenter(const void *obj);
+Vector3 PointCenter(const void *obj);
+
+Collision CCDPenetration(const void * obj1, ccd_support_fn support1, const void * obj2, ccd_support_fn support2);
+Collision VertexMeshVertexMeshPenetration(const void * a, const void * b);
+Collision VertexMeshPointPenetration(const void * a, const void * b);
+Collision VertexMeshBoxPenetration(const void * a, const void * b);
+Collision BoxBoxPenetration(const void * a, const void * b);
+Collision BoxPointPenetration(const void * a, const void * b);
+Collision VertexMeshPointPenetrationMPR(const void * a, const void * b);
+Collision VertexMeshBoxPenetrationMPR(const void * a, const void * b);
+bool VertexMeshPointIntersect(const void * a, const void * b);
+bool VertexMeshBoxIntersect(const void * a, const void * b);
+
 Collision VertexMeshCollision(VertexMesh a, VertexMesh b);
 VertexMesh MeshToVertexMesh(Mesh mesh, Matrix matTransform);
+VertexMesh MeshToVertexMeshArena(Arena * arena, Mesh mesh, Matrix matTransform);
+VertexMesh MeshColliderToVertexMeshArena(Arena * arena, MeshCollider m);
 Collision MeshCollision(MeshCollider a, MeshCollider b);
-MeshCollider * GetModelMeshColliders(Model model, Matrix * transform);
-MeshCollider GetModelMeshCollider0(Model model, Matrix * transform);
+MeshCollider MakeMeshCollider(Mesh * mesh, Matrix transform);
+MeshCollider * GetModelMeshColliders(Model model, Matrix transform);
+MeshCollider * GetModelMeshCollidersArena(Arena * arena, Model model, Matrix transform);
+MeshCollider GetModelMeshCollider0(Model model, Matrix transform);
+void UpdateMeshColliderBounds(ecs_iter_t * it);
 
 Collision PointMeshCollision(Vector3 p, MeshCollider m);
+Collision PointMeshCollisionTier(Vector3 p, MeshCollider m, CollisionTier tier);
+bool PointMeshIntersect(Vector3 p, MeshCollider m);
 Collision BoxMeshCollision(BoundingBox box, MeshCollider m);
+Collision BoxMeshCollisionTier(BoundingBox box, MeshCollider m, CollisionTier tier);
+bool BoxMeshIntersect(BoundingBox box, MeshCollider m);
 Collision BoxBoxCollision(BoundingBox b1, BoundingBox b2);
 Collision PointBoxCollision(Vector3 p, BoundingBox box);
 
+BoundingBox SweptBoundingBox(BoundingBox box, Vector3 move);
+TimeOfImpact BoxMeshSweep(BoundingBox box, Vector3 move, MeshCollider m);
+TimeOfImpact BoxBoxSweep(BoundingBox box, Vector3 move, BoundingBox other);
+
 RayCollision RayToMeshColliders(Ray ray, float distance);
 RayCollision RayToBoxColliders(Ray ray, float distance);
 RayCollision RayToAnyCollider(Ray ray, float distance);
@@ -0,0 +1,126 @@
+#include "collisionstats.h"
+#include "main.h"
+
+ECS_COMPONENT_DECLARE(CollisionFrameStats);
+
+// a slot per thread on cache line boundaries, so two threads never count into the same line.
+// the alignment rounds the size up to whole lines too
+typedef struct CollisionSlot {
+    _Alignas(64) CollisionCounters counters;
+} CollisionSlot;
+
+_Static_assert(sizeof(CollisionSlot) % 64 == 0, "CollisionSlot has to fill whole cache lines");
+
+static CollisionSlot slots[COLLISION_STATS_THREADS];
+static int32_t slotCount;
+static CollisionCounters uncounted;             // shared by the threads that didn't get a slot
+static CollisionCounters lastCounters;
+
+// CollisionFrameStats members in order, with what the explorer shows for each
+static const struct { const char * name; const char * brief; } frameStatMembers[] = {
+    { "aabb_tests", "broadphase box checks" },
+    { "aabb_rejects", "pairs ruled out by their boxes" },
+    { "cull_ratio", "share of box checks that skipped the narrowphase" },
+    { "gjk_calls", "GJK runs" },
+    { "gjk_iterations", "GJK iterations" },
+    { "gjk_iterations_per_call", "GJK iterations per run" },
+    { "epa_calls", "EPA runs" },
+    { "epa_expansions", "EPA polytope expansions" },
+    { "mpr_calls", "MPR runs" },
+    { "mpr_iterations", "MPR iterations" },
+    { "sweeps", "GJK raycast sweeps" },
+    { "sweep_iterations", "GJK raycast iterations" },
+    { "ray_box_tests", "ray to collider box tests" },
+    { "ray_mesh_tests", "ray to mesh triangle tests" },
+    { "actor_moves", "MoveActorBox calls" },
+    { "ground_tests", "ActorTestGround calls" },
+};
+
+#define FRAME_STAT_COUNT ((int)(sizeof(frameStatMembers) / sizeof(frameStatMembers[0])))
+_Static_assert(FRAME_STAT_COUNT * sizeof(double) == sizeof(CollisionFrameStats), "frameStatMembers out of step with CollisionFrameStats");
+
+#if USE_COLLISION_COUNTERS
+THREAD_LOCAL CollisionCounters * collisionCounters;
+
+CollisionCounters * ClaimCollisionCounters(void) {
+    int32_t slot = ecs_os_ainc(&slotCount) - 1;
+    collisionCounters = slot < COLLISION_STATS_THREADS ? &slots[slot].counters : &uncounted;
+    return collisionCounters;
+}
+#endif
+
+CollisionCounters SumCollisionCounters(void) {
+    CollisionCounters sum = { 0 };
+    int count = slotCount < COLLISION_STATS_THREADS ? slotCount : COLLISION_STATS_THREADS;
+    for(int i = 0; i < count; i ++) {
+        const CollisionCounters * c = &slots[i].counters;
+        sum.aabbTests += c->aabbTests;
+        sum.aabbRejects += c->aabbRejects;
+        sum.gjkCalls += c->gjkCalls;
+        sum.gjkIterations += c->gjkIterations;
+        sum.epaCalls += c->epaCalls;
+        sum.epaExpansions += c->epaExpansions;
+        sum.mprCalls += c->mprCalls;
+        sum.mprIterations += c->mprIterations;
+        sum.sweeps += c->sweeps;
+        sum.sweepIterations += c->sweepIterations;
+        sum.rayBoxTests += c->rayBoxTests;
+        sum.rayMeshTests += c->rayMeshTests;
+        sum.actorMoves += c->actorMoves;
+        sum.groundTests += c->groundTests;
+    }
+    return sum;
+}
+
+CollisionFrameStats CollisionFrameStatsBetween(const CollisionCounters * before, const CollisionCounters * after) {
+    CollisionFrameStats s = {
+        .aabb_tests = (double)(after->aabbTests - before->aabbTests),
+        .aabb_rejects = (double)(after->aabbRejects - before->aabbRejects),
+        .gjk_calls = (double)(after->gjkCalls - before->gjkCalls),
+        .gjk_iterations = (double)(after->gjkIterations - before->gjkIterations),
+        .epa_calls = (double)(after->epaCalls - before->epaCalls),
+        .epa_expansions = (double)(after->epaExpansions - before->epaExpansions),
+        .mpr_calls = (double)(after->mprCalls - before->mprCalls),
+        .mpr_iterations = (double)(after->mprIterations - before->mprIterations),
+        .sweeps = (double)(after->sweeps - before->sweeps),
+        .sweep_iterations = (double)(after->sweepIterations - before->sweepIterations),
+        .ray_box_tests = (double)(after->rayBoxTests - before->rayBoxTests),
+        .ray_mesh_tests = (double)(after->rayMeshTests - before->rayMeshTests),
+        .actor_moves = (double)(after->actorMoves - before->actorMoves),
+        .ground_tests = (double)(after->groundTests - before->groundTests),
+    };
+    s.cull_ratio = s.aabb_tests > 0 ? s.aabb_rejects / s.aabb_tests : 0;
+    s.gjk_iterations_per_call = s.gjk_calls > 0 ? s.gjk_iterations / s.gjk_calls : 0;
+    return s;
+}
+
+void RegisterCollisionMetrics(void) {
+    ECS_IMPORT(world, FlecsMetrics);
+    ECS_COMPONENT_DEFINE(world, CollisionFrameStats);
+
+    ecs_struct_desc_t desc = { .entity = ecs_id(CollisionFrameStats) };
+    for(int i = 0; i < FRAME_STAT_COUNT; i ++) {
+        desc.members[i] = (ecs_member_t){ .name = frameStatMembers[i].name, .type = ecs_id(ecs_f64_t) };
+    }
+    ecs_struct_init(world, &desc);
+
+    // the singleton is the one entity with the members, so each metric has one instance
+    ecs_singleton_set(world, CollisionFrameStats, { 0 });
+    for(int i = 0; i < FRAME_STAT_COUNT; i ++) {
+        ecs_metric(world, {
+            .entity = ecs_entity(world, { .name = TextFormat("metrics.collision.%s", frameStatMembers[i].name) }),
+            .member = ecs_lookup_child(world, ecs_id(CollisionFrameStats), frameStatMembers[i].name),
+            .kind = EcsGauge,
+            .brief = frameStatMembers[i].brief,
+        });
+    }
+
+    lastCounters = SumCollisionCounters();
+}
+
+void UpdateCollisionStats(void) {
+    CollisionCounters now = SumCollisionCounters();
+    CollisionFrameStats frame = CollisionFrameStatsBetween(&lastCounters, &now);
+    lastCounters = now;
+    ecs_singleton_set_ptr(world, CollisionFrameStats, &frame);
+}
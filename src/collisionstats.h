@@ -0,0 +1,71 @@
+#ifndef _collisionstats
+#define _collisionstats
+
+#include "headers.h"
+
+// what the collision queries did: box checks, how many pairs they threw out, and how hard GJK, EPA and
+// MPR worked on the rest. each thread counts into its own slot, summed once a frame into the
+// CollisionFrameStats singleton, which flecs metrics read. with USE_COLLISION_COUNTERS 0 it all compiles out
+
+#define COLLISION_STATS_THREADS 16      // threads past this don't count
+
+typedef struct CollisionCounters {
+    int64_t aabbTests;          // box checks in front of a narrowphase
+    int64_t aabbRejects;        // pairs the box check ruled out
+    int64_t gjkCalls;
+    int64_t gjkIterations;
+    int64_t epaCalls;
+    int64_t epaExpansions;
+    int64_t mprCalls;
+    int64_t mprIterations;
+    int64_t sweeps;             // GJKRaycast
+    int64_t sweepIterations;
+    int64_t rayBoxTests;
+    int64_t rayMeshTests;       // rays that got past a collider's box to its triangles
+    int64_t actorMoves;
+    int64_t groundTests;
+} CollisionCounters;
+
+// one frame's counts, doubles so flecs metrics can read them as members
+typedef struct CollisionFrameStats {
+    double aabb_tests;
+    double aabb_rejects;
+    double cull_ratio;          // aabb_rejects / aabb_tests
+    double gjk_calls;
+    double gjk_iterations;
+    double gjk_iterations_per_call;
+    double epa_calls;
+    double epa_expansions;
+    double mpr_calls;
+    double mpr_iterations;
+    double sweeps;
+    double sweep_iterations;
+    double ray_box_tests;
+    double ray_mesh_tests;
+    double actor_moves;
+    double ground_tests;
+} CollisionFrameStats;
+
+extern ECS_COMPONENT_DECLARE(CollisionFrameStats);
+
+#if USE_COLLISION_COUNTERS
+extern THREAD_LOCAL CollisionCounters * collisionCounters;
+CollisionCounters * ClaimCollisionCounters(void);
+#define COLLISION_COUNT(field, n) ((collisionCounters != NULL ? collisionCounters : ClaimCollisionCounters())->field += (n))
+#else
+#define COLLISION_COUNT(field, n) ((void)0)
+#endif
+
+// every thread's counts since the start. other threads' slots are read while they may be counting,
+// so a frame can be off by whatever they did meanwhile
+CollisionCounters SumCollisionCounters(void);
+CollisionFrameStats CollisionFrameStatsBetween(const CollisionCounters * before, const CollisionCounters * after);
+
+// after ecs_init, registers CollisionFrameStats with reflection and a gauge metric per member
+// under metrics.collision
+void RegisterCollisionMetrics(void);
+
+// once a frame before ecs_progress, so the metrics pick up the frame before
+void UpdateCollisionStats(void);
+
+#endif
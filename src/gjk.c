@@ -0,0 +1,378 @@
+#include "gjk.h"
+#include "headers.h"
+
+// closest point to the origin on segment ab
+// keep gets a bit set for each vertex the point depends on
+static Vector3 SegmentClosestPoint(Vector3 a, Vector3 b, int * keep) {
+    Vector3 ab = Vector3Subtract(b, a);
+    float t = -Vector3DotProduct(a, ab);
+    if(t <= 0.0f) {
+        *keep = 1;
+        return a;
+    }
+    float denom = Vector3DotProduct(ab, ab);
+    if(t >= denom) {
+        *keep = 2;
+        return b;
+    }
+    *keep = 3;
+    return Vector3Add(a, Vector3Scale(ab, t / denom));
+}
+
+// closest point to the origin on triangle abc, by voronoi regions (Ericson, RTCD 5.1.5)
+static Vector3 TriangleClosestPoint(Vector3 a, Vector3 b, Vector3 c, int * keep) {
+    Vector3 ab = Vector3Subtract(b, a);
+    Vector3 ac = Vector3Subtract(c, a);
+
+    Vector3 ap = Vector3Negate(a);
+    float d1 = Vector3DotProduct(ab, ap);
+    float d2 = Vector3DotProduct(ac, ap);
+    if(d1 <= 0.0f && d2 <= 0.0f) {
+        *keep = 1;
+        return a;
+    }
+
+    Vector3 bp = Vector3Negate(b);
+    float d3 = Vector3DotProduct(ab, bp);
+    float d4 = Vector3DotProduct(ac, bp);
+    if(d3 >= 0.0f && d4 <= d3) {
+        *keep = 2;
+        return b;
+    }
+
+    float vc = d1*d4 - d3*d2;
+    if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        *keep = 3;
+        return Vector3Add(a, Vector3Scale(ab, d1 / (d1 - d3)));
+    }
+
+    Vector3 cp = Vector3Negate(c);
+    float d5 = Vector3DotProduct(ab, cp);
+    float d6 = Vector3DotProduct(ac, cp);
+    if(d6 >= 0.0f && d5 <= d6) {
+        *keep = 4;
+        return c;
+    }
+
+    float vb = d5*d2 - d1*d6;
+    if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        *keep = 5;
+        return Vector3Add(a, Vector3Scale(ac, d2 / (d2 - d6)));
+    }
+
+    float va = d3*d6 - d5*d4;
+    if(va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        *keep = 6;
+        return Vector3Add(b, Vector3Scale(Vector3Subtract(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6))));
+    }
+
+    *keep = 7;
+    float denom = 1.0f / (va + vb + vc);
+    return Vector3Add(a, Vector3Add(Vector3Scale(ab, vb * denom), Vector3Scale(ac, vc * denom)));
+}
+
+// is the origin on the other side of plane abc from d?
+static bool OriginOutsidePlane(Vector3 a, Vector3 b, Vector3 c, Vector3 d) {
+    Vector3 n = Vector3CrossProduct(Vector3Subtract(b, a), Vector3Subtract(c, a));
+    float signOrigin = -Vector3DotProduct(a, n);
+    float signD = Vector3DotProduct(Vector3Subtract(d, a), n);
+    // degenerate tetrahedrons count as outside so a face still gets tested
+    return signOrigin * signD <= 0.0f;
+}
+
+Vector3 SimplexClosestPoint(const Vector3 * s, int count, int * keep) {
+    switch(count) {
+        case 1:
+            *keep = 1;
+            return s[0];
+        case 2:
+            return SegmentClosestPoint(s[0], s[1], keep);
+        case 3:
+            return TriangleClosestPoint(s[0], s[1], s[2], keep);
+    }
+
+    // tetrahedron, test every face the origin is in front of
+    static const int faces[4][4] = {
+        { 0, 1, 2, 3 },
+        { 0, 2, 3, 1 },
+        { 0, 3, 1, 2 },
+        { 1, 3, 2, 0 },
+    };
+
+    Vector3 best = { 0 };
+    float bestDist = FLT_MAX;
+    *keep = 15; // origin inside unless a face says otherwise
+
+    for(int f = 0; f < 4; f ++) {
+        const int * i = faces[f];
+        if(!OriginOutsidePlane(s[i[0]], s[i[1]], s[i[2]], s[i[3]]))
+            continue;
+
+        int faceKeep;
+        Vector3 p = TriangleClosestPoint(s[i[0]], s[i[1]], s[i[2]], &faceKeep);
+        float dist = Vector3LengthSqr(p);
+        if(dist < bestDist) {
+            bestDist = dist;
+            best = p;
+            *keep = 0;
+            for(int k = 0; k < 3; k ++) {
+                if(faceKeep & (1 << k))
+                    *keep |= 1 << i[k];
+            }
+        }
+    }
+
+    return best;
+}
+
+// support of the minkowski difference still - moving
+static Vector3 DifferenceSupport(const void * moving, SupportFunc movingSupport, const void * still, SupportFunc stillSupport, Vector3 dir) {
+    return Vector3Subtract(stillSupport(still, dir), movingSupport(moving, Vector3Negate(dir)));
+}
+
+// GJK ray cast (van den Bergen, "Ray Casting against General Convex Objects")
+// the moving shape touches the still one at t*move when t*move lies inside still - moving,
+// so cast a ray from the origin along move against that difference.
+// a cast that doesn't converge within GJK_MAX_ITERATIONS is a miss, lambda can still be well short of the surface
+TimeOfImpact GJKRaycast(const void * moving, SupportFunc movingSupport, const void * still, SupportFunc stillSupport, Vector3 move) {
+    TimeOfImpact result = { false, 0.0f, { 0 }, false };
+
+    Vector3 x = { 0 };      // current point on the ray
+    Vector3 points[4];      // simplex, as points of the difference
+    int count = 0;
+
+    Vector3 v = Vector3Subtract(x, DifferenceSupport(moving, movingSupport, still, stillSupport, move));
+    Vector3 normal = { 0 };
+    float lambda = 0.0f;
+    bool surface = false;
+    COLLISION_COUNT(sweeps, 1);
+
+    for(int iter = 0; iter < GJK_MAX_ITERATIONS && Vector3LengthSqr(v) > GJK_TOLERANCE*GJK_TOLERANCE; iter ++) {
+        COLLISION_COUNT(sweepIterations, 1);
+        Vector3 p = DifferenceSupport(moving, movingSupport, still, stillSupport, v);
+        Vector3 w = Vector3Subtract(x, p);
+
+        float vw = Vector3DotProduct(v, w);
+        bool advanced = vw > 0.0f;
+        if(advanced) {
+            // p's plane separates x from the difference, move x up to it
+            float vr = Vector3DotProduct(v, move);
+            if(vr >= 0.0f)
+                return result;
+
+            lambda -= vw / vr;
+            if(lambda > 1.0f)
+                return result;
+
+            x = Vector3Scale(move, lambda);
+            normal = v;
+        }
+
+        bool duplicate = false;
+        for(int i = 0; i < count; i ++) {
+            if(Vector3DistanceSqr(points[i], p) < GJK_TOLERANCE*GJK_TOLERANCE)
+                duplicate = true;
+        }
+
+        if(!duplicate)
+            points[count ++] = p;
+        else if(!advanced) {
+            // no progress left to make, x is on the surface
+            surface = true;
+            break;
+        }
+
+        Vector3 simplex[4];
+        for(int i = 0; i < count; i ++) {
+            simplex[i] = Vector3Subtract(x, points[i]);
+        }
+
+        int keep;
+        v = SimplexClosestPoint(simplex, count, &keep);
+
+        int kept = 0;
+        for(int i = 0; i < count; i ++) {
+            if(keep & (1 << i))
+                points[kept ++] = points[i];
+        }
+        count = kept;
+    }
+
+    if(!surface && Vector3LengthSqr(v) > GJK_TOLERANCE*GJK_TOLERANCE)
+        return result;
+
+    result.hit = true;
+    result.toi = lambda;
+
+    // x never moved, the origin is inside the difference: already intersecting at t = 0
+    if(lambda == 0.0f && Vector3LengthSqr(normal) == 0.0f) {
+        result.overlapping = true;
+        return result;
+    }
+
+    result.normal = Vector3Normalize(normal);
+    return result;
+}
+
+static bool EPAAddFace(EPAPolytope * poly, int i0, int i1, int i2) {
+    if(poly->faceCount >= EPA_MAX_FACES)
+        return false;
+
+    Vector3 p0 = poly->verts[i0].p;
+    Vector3 normal = Vector3CrossProduct(Vector3Subtract(poly->verts[i1].p, p0), Vector3Subtract(poly->verts[i2].p, p0));
+    if(Vector3LengthSqr(normal) <= GJK_TOLERANCE*GJK_TOLERANCE*GJK_TOLERANCE*GJK_TOLERANCE)
+        return false; // sliver, leave it out
+
+    normal = Vector3Normalize(normal);
+    poly->faces[poly->faceCount ++] = (EPAFace){ { i0, i1, i2 }, normal, Vector3DotProduct(normal, p0) };
+    return true;
+}
+
+bool EPAInit(EPAPolytope * poly, const SupportPoint * tetrahedron) {
+    poly->vertCount = 4;
+    poly->faceCount = 0;
+    for(int i = 0; i < 4; i ++) {
+        poly->verts[i] = tetrahedron[i];
+    }
+
+    static const int faces[4][4] = {
+        { 0, 1, 2, 3 },
+        { 0, 3, 1, 2 },
+        { 0, 2, 3, 1 },
+        { 1, 3, 2, 0 },
+    };
+
+    for(int f = 0; f < 4; f ++) {
+        const int * i = faces[f];
+        Vector3 p0 = poly->verts[i[0]].p;
+        Vector3 normal = Vector3CrossProduct(Vector3Subtract(poly->verts[i[1]].p, p0), Vector3Subtract(poly->verts[i[2]].p, p0));
+
+        // wind every face away from the vertex opposite it
+        bool added;
+        if(Vector3DotProduct(normal, Vector3Subtract(poly->verts[i[3]].p, p0)) > 0.0f)
+            added = EPAAddFace(poly, i[0], i[2], i[1]);
+        else
+            added = EPAAddFace(poly, i[0], i[1], i[2]);
+
+        if(!added)
+            return false;
+    }
+
+    return true;
+}
+
+EPAFace * EPANearestFace(EPAPolytope * poly) {
+    EPAFace * nearest = &poly->faces[0];
+    for(int i = 1; i < poly->faceCount; i ++) {
+        if(poly->faces[i].dist < nearest->dist)
+            nearest = &poly->faces[i];
+    }
+    return nearest;
+}
+
+// add p to the polytope, replacing every face it can see with a fan from the horizon to p
+bool EPAExpand(EPAPolytope * poly, SupportPoint p) {
+    if(poly->vertCount >= EPA_MAX_VERTS)
+        return false;
+
+    int edges[EPA_MAX_EDGES][2];
+    int edgeCount = 0;
+
+    for(int f = 0; f < poly->faceCount; f ++) {
+        EPAFace * face = &poly->faces[f];
+        if(Vector3DotProduct(face->normal, Vector3Subtract(p.p, poly->verts[face->v[0]].p)) <= 0.0f)
+            continue;
+
+        for(int j = 0; j < 3; j ++) {
+            int e0 = face->v[j];
+            int e1 = face->v[(j + 1) % 3];
+
+            // an edge shared by two visible faces isn't on the horizon
+            bool shared = false;
+            for(int k = 0; k < edgeCount; k ++) {
+                if(edges[k][0] == e1 && edges[k][1] == e0) {
+                    edges[k][0] = edges[edgeCount - 1][0];
+                    edges[k][1] = edges[edgeCount - 1][1];
+                    edgeCount --;
+                    shared = true;
+                    break;
+                }
+            }
+            if(!shared) {
+                if(edgeCount >= EPA_MAX_EDGES)
+                    return false;
+                edges[edgeCount][0] = e0;
+                edges[edgeCount][1] = e1;
+                edgeCount ++;
+            }
+        }
+
+        *face = poly->faces[-- poly->faceCount];
+        f --;
+    }
+
+    if(edgeCount == 0)
+        return false;
+
+    int index = poly->vertCount ++;
+    poly->verts[index] = p;
+
+    for(int k = 0; k < edgeCount; k ++) {
+        EPAAddFace(poly, edges[k][0], edges[k][1], index);
+    }
+
+    return poly->faceCount > 0;
+}
+
+// contact point halfway between the points of a and b that make up point on triangle s0 s1 s2
+static Vector3 WitnessMidpoint(const SupportPoint * s0, const SupportPoint * s1, const SupportPoint * s2, Vector3 point) {
+    Vector3 e0 = Vector3Subtract(s1->p, s0->p);
+    Vector3 e1 = Vector3Subtract(s2->p, s0->p);
+    Vector3 e2 = Vector3Subtract(point, s0->p);
+    float d00 = Vector3DotProduct(e0, e0);
+    float d01 = Vector3DotProduct(e0, e1);
+    float d11 = Vector3DotProduct(e1, e1);
+    float d20 = Vector3DotProduct(e2, e0);
+    float d21 = Vector3DotProduct(e2, e1);
+    float denom = d00*d11 - d01*d01;
+
+    // barycentric coordinates, or the centroid for a sliver
+    float u = 1.0f/3.0f, v = 1.0f/3.0f, w = 1.0f/3.0f;
+    if(fabsf(denom) > 0.0f) {
+        v = (d11*d20 - d01*d21) / denom;
+        w = (d00*d21 - d01*d20) / denom;
+        u = 1.0f - v - w;
+    }
+
+    Vector3 pointA = Vector3Add(Vector3Add(Vector3Scale(s0->a, u), Vector3Scale(s1->a, v)), Vector3Scale(s2->a, w));
+    Vector3 pointB = Vector3Add(Vector3Add(Vector3Scale(s0->b, u), Vector3Scale(s1->b, v)), Vector3Scale(s2->b, w));
+    return Vector3Scale(Vector3Add(pointA, pointB), 0.5f);
+}
+
+Collision EPAResult(const EPAFace * face, const EPAPolytope * poly) {
+    const SupportPoint * s0 = &poly->verts[face->v[0]];
+    const SupportPoint * s1 = &poly->verts[face->v[1]];
+    const SupportPoint * s2 = &poly->verts[face->v[2]];
+
+    Vector3 projection = Vector3Scale(face->normal, face->dist);
+
+    float depth = face->dist > 0.0f ? face->dist : 0.0f;
+    return (Collision){ depth > 0.0f, depth, face->normal, WitnessMidpoint(s0, s1, s2, projection) };
+}
+
+// depth and direction from the origin to the final MPR portal
+Collision PortalResult(const SupportPoint * portal) {
+    Vector3 triangle[3] = { portal[1].p, portal[2].p, portal[3].p };
+    int keep;
+    Vector3 closest = SimplexClosestPoint(triangle, 3, &keep);
+    float depth = Vector3Length(closest);
+
+    // touching, any direction would do so use the portal's
+    Vector3 direction;
+    if(depth > 0.0f)
+        direction = Vector3Scale(closest, 1.0f / depth);
+    else
+        direction = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(triangle[1], triangle[0]), Vector3Subtract(triangle[2], triangle[0])));
+
+    return (Collision){ depth > 0.0f, depth, direction, WitnessMidpoint(&portal[1], &portal[2], &portal[3], closest) };
+}
@@ -0,0 +1,368 @@
+#ifndef _gjk
+#define _gjk
+
+#include "headers.h"
+#include "collisionstats.h"
+
+// float-native convex queries, in place of going through libccd's doubles
+
+#define GJK_MAX_ITERATIONS 64
+#define GJK_TOLERANCE 0.0001f
+
+#define MPR_MAX_ITERATIONS 100
+#define MPR_TOLERANCE 0.0001f
+#define MPR_EPSILON 0.000001f
+
+#define EPA_MAX_ITERATIONS 100
+#define EPA_TOLERANCE 0.0001f
+#define EPA_MAX_VERTS (EPA_MAX_ITERATIONS + 4)
+#define EPA_MAX_FACES (EPA_MAX_VERTS * 2)
+#define EPA_MAX_EDGES 64
+
+#if defined(_MSC_VER)
+#define GJK_INLINE static __forceinline
+#else
+#define GJK_INLINE static inline __attribute__((always_inline))
+#endif
+
+// returns the point of obj furthest along dir
+typedef Vector3 (*SupportFunc)(const void * obj, Vector3 dir);
+// returns any point inside obj, MPR starts from the difference of two of these
+typedef Vector3 (*CenterFunc)(const void * obj);
+
+typedef struct Collision {
+    bool hit;
+    float depth;
+    Vector3 direction;
+    Vector3 point;
+} Collision;
+
+typedef struct TimeOfImpact {
+    bool hit;
+    float toi;          // fraction of the move at first contact, 0 if already touching
+    Vector3 normal;     // points out of the still shape, towards the moving one. zero when overlapping
+    bool overlapping;   // hit at toi 0 with the shapes already intersecting, there's no contact normal to give
+} TimeOfImpact;
+
+// point of the minkowski difference a - b, with the points of a and b it came from
+typedef struct SupportPoint {
+    Vector3 p;
+    Vector3 a;
+    Vector3 b;
+} SupportPoint;
+
+typedef struct EPAFace {
+    int v[3];           // counter clockwise seen from outside
+    Vector3 normal;
+    float dist;         // distance of the face's plane from the origin
+} EPAFace;
+
+typedef struct EPAPolytope {
+    SupportPoint verts[EPA_MAX_VERTS];
+    EPAFace faces[EPA_MAX_FACES];
+    int vertCount;
+    int faceCount;
+} EPAPolytope;
+
+Vector3 SimplexClosestPoint(const Vector3 * simplex, int count, int * keep);
+TimeOfImpact GJKRaycast(const void * moving, SupportFunc movingSupport, const void * still, SupportFunc stillSupport, Vector3 move);
+
+bool EPAInit(EPAPolytope * poly, const SupportPoint * tetrahedron);
+EPAFace * EPANearestFace(EPAPolytope * poly);
+bool EPAExpand(EPAPolytope * poly, SupportPoint p);
+Collision EPAResult(const EPAFace * face, const EPAPolytope * poly);
+Collision PortalResult(const SupportPoint * portal);
+
+GJK_INLINE SupportPoint GJKSupport(const void * a, SupportFunc supportA, const void * b, SupportFunc supportB, Vector3 dir) {
+    SupportPoint s;
+    s.a = supportA(a, dir);
+    s.b = supportB(b, Vector3Negate(dir));
+    s.p = Vector3Subtract(s.a, s.b);
+    return s;
+}
+
+// boolean GJK, on overlap leaves the last simplex in simplex/count
+GJK_INLINE bool GJKIntersectInline(const void * a, SupportFunc supportA, const void * b, SupportFunc supportB, SupportPoint * simplex, int * count) {
+    simplex[0] = GJKSupport(a, supportA, b, supportB, (Vector3){ 1.0f, 0.0f, 0.0f });
+    *count = 1;
+    Vector3 v = simplex[0].p;
+    COLLISION_COUNT(gjkCalls, 1);
+
+    for(int iter = 0; iter < GJK_MAX_ITERATIONS; iter ++) {
+        COLLISION_COUNT(gjkIterations, 1);
+        if(Vector3LengthSqr(v) <= GJK_TOLERANCE*GJK_TOLERANCE)
+            return true;
+
+        SupportPoint w = GJKSupport(a, supportA, b, supportB, Vector3Negate(v));
+
+        // w's plane separates the origin from a - b
+        if(Vector3DotProduct(v, w.p) > 0.0f)
+            return false;
+
+        for(int i = 0; i < *count; i ++) {
+            // no progress, the origin is on the surface
+            if(Vector3DistanceSqr(simplex[i].p, w.p) < GJK_TOLERANCE*GJK_TOLERANCE)
+                return false;
+        }
+
+        simplex[(*count) ++] = w;
+
+        Vector3 points[4];
+        for(int i = 0; i < *count; i ++) {
+            points[i] = simplex[i].p;
+        }
+
+        int keep;
+        v = SimplexClosestPoint(points, *count, &keep);
+        if(keep == 15)
+            return true;
+
+        int kept = 0;
+        for(int i = 0; i < *count; i ++) {
+            if(keep & (1 << i))
+                simplex[kept ++] = simplex[i];
+        }
+        *count = kept;
+    }
+
+    return false;
+}
+
+// grow a simplex that ended with the origin on its boundary into a tetrahedron
+// returns false when a - b is flat there, meaning the shapes only touch
+GJK_INLINE bool GJKBlowUpSimplex(const void * a, SupportFunc supportA, const void * b, SupportFunc supportB, SupportPoint * simplex, int * count) {
+    if(*count == 1)
+        return false;
+
+    if(*count == 2) {
+        Vector3 ab = Vector3Subtract(simplex[1].p, simplex[0].p);
+        Vector3 axis = { 1.0f, 0.0f, 0.0f };
+        if(fabsf(ab.y) < fabsf(ab.x) && fabsf(ab.y) <= fabsf(ab.z))
+            axis = (Vector3){ 0.0f, 1.0f, 0.0f };
+        else if(fabsf(ab.z) < fabsf(ab.x))
+            axis = (Vector3){ 0.0f, 0.0f, 1.0f };
+        Vector3 dir = Vector3CrossProduct(ab, axis);
+
+        // spin around the segment until something sticks out of its line
+        for(int i = 0; i < 6; i ++) {
+            SupportPoint c = GJKSupport(a, supportA, b, supportB, dir);
+            Vector3 ac = Vector3Subtract(c.p, simplex[0].p);
+            if(Vector3LengthSqr(Vector3CrossProduct(ab, ac)) > GJK_TOLERANCE*GJK_TOLERANCE) {
+                simplex[(*count) ++] = c;
+                break;
+            }
+            dir = Vector3RotateByAxisAngle(dir, ab, 60.0f*DEG2RAD);
+        }
+        if(*count == 2)
+            return false;
+    }
+
+    Vector3 normal = Vector3CrossProduct(Vector3Subtract(simplex[1].p, simplex[0].p), Vector3Subtract(simplex[2].p, simplex[0].p));
+    SupportPoint d = GJKSupport(a, supportA, b, supportB, normal);
+    if(fabsf(Vector3DotProduct(normal, Vector3Subtract(d.p, simplex[0].p))) <= GJK_TOLERANCE * Vector3Length(normal)) {
+        d = GJKSupport(a, supportA, b, supportB, Vector3Negate(normal));
+        if(fabsf(Vector3DotProduct(normal, Vector3Subtract(d.p, simplex[0].p))) <= GJK_TOLERANCE * Vector3Length(normal))
+            return false;
+    }
+    simplex[(*count) ++] = d;
+
+    return true;
+}
+
+// penetration of b into a, same contract as ccdGJKPenetration:
+// moving b by direction * depth leaves the shapes touching
+GJK_INLINE Collision GJKPenetrationInline(const void * a, SupportFunc supportA, const void * b, SupportFunc supportB) {
+    SupportPoint simplex[4];
+    int count;
+    if(!GJKIntersectInline(a, supportA, b, supportB, simplex, &count))
+        return (Collision){ false };
+
+    if(count < 4 && !GJKBlowUpSimplex(a, supportA, b, supportB, simplex, &count))
+        return (Collision){ false };
+
+    EPAPolytope poly;
+    if(!EPAInit(&poly, simplex))
+        return (Collision){ false };
+    COLLISION_COUNT(epaCalls, 1);
+
+    // copied, expanding rewrites the face list
+    EPAFace face = *EPANearestFace(&poly);
+    for(int iter = 0; iter < EPA_MAX_ITERATIONS; iter ++) {
+        SupportPoint p = GJKSupport(a, supportA, b, supportB, face.normal);
+
+        // can't push the face out any further
+        if(Vector3DotProduct(face.normal, p.p) - face.dist < EPA_TOLERANCE)
+            break;
+
+        if(!EPAExpand(&poly, p))
+            break;
+        COLLISION_COUNT(epaExpansions, 1);
+        face = *EPANearestFace(&poly);
+    }
+
+    return EPAResult(&face, &poly);
+}
+
+// minkowski portal refinement (XenoCollide, following libccd's mpr.c)
+// portal[0] is inside a - b, portal[1..3] is a triangle on its surface the ray from portal[0] through the origin passes through
+
+GJK_INLINE Vector3 MPRPortalDir(const SupportPoint * portal) {
+    return Vector3Normalize(Vector3CrossProduct(Vector3Subtract(portal[2].p, portal[1].p), Vector3Subtract(portal[3].p, portal[1].p)));
+}
+
+GJK_INLINE bool MPRReachedTolerance(const SupportPoint * portal, SupportPoint v4, Vector3 dir) {
+    float dv4 = Vector3DotProduct(v4.p, dir);
+    float gap = dv4 - Vector3DotProduct(portal[1].p, dir);
+    gap = fminf(gap, dv4 - Vector3DotProduct(portal[2].p, dir));
+    gap = fminf(gap, dv4 - Vector3DotProduct(portal[3].p, dir));
+    return gap <= MPR_TOLERANCE;
+}
+
+// swap v4 in for whichever portal point keeps the origin's ray going through the portal
+GJK_INLINE void MPRExpandPortal(SupportPoint * portal, SupportPoint v4) {
+    Vector3 v4v0 = Vector3CrossProduct(v4.p, portal[0].p);
+    if(Vector3DotProduct(portal[1].p, v4v0) > 0.0f) {
+        if(Vector3DotProduct(portal[2].p, v4v0) > 0.0f)
+            portal[1] = v4;
+        else
+            portal[3] = v4;
+    }
+    else {
+        if(Vector3DotProduct(portal[3].p, v4v0) > 0.0f)
+            portal[2] = v4;
+        else
+            portal[1] = v4;
+    }
+}
+
+// returns -1 when separated, 0 with a full portal, 1 when the origin is on portal[1], 2 when it is on portal[0]-portal[1]
+GJK_INLINE int MPRDiscoverPortal(const void * a, SupportFunc supportA, CenterFunc centerA, const void * b, SupportFunc supportB, CenterFunc centerB, SupportPoint * portal) {
+    portal[0].a = centerA(a);
+    portal[0].b = centerB(b);
+    portal[0].p = Vector3Subtract(portal[0].a, portal[0].b);
+
+    // centers on top of each other, nudge so there's a direction to search in
+    if(Vector3LengthSqr(portal[0].p) < MPR_EPSILON*MPR_EPSILON)
+        portal[0].p.x += MPR_EPSILON * 10.0f;
+
+    Vector3 dir = Vector3Normalize(Vector3Negate(portal[0].p));
+    portal[1] = GJKSupport(a, supportA, b, supportB, dir);
+    if(Vector3DotProduct(portal[1].p, dir) <= MPR_EPSILON)
+        return -1;
+
+    dir = Vector3CrossProduct(portal[0].p, portal[1].p);
+    if(Vector3LengthSqr(dir) < MPR_EPSILON*MPR_EPSILON) {
+        if(Vector3LengthSqr(portal[1].p) < MPR_EPSILON*MPR_EPSILON)
+            return 1;
+        return 2;
+    }
+
+    dir = Vector3Normalize(dir);
+    portal[2] = GJKSupport(a, supportA, b, supportB, dir);
+    if(Vector3DotProduct(portal[2].p, dir) <= MPR_EPSILON)
+        return -1;
+
+    // face the portal away from the origin
+    dir = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(portal[1].p, portal[0].p), Vector3Subtract(portal[2].p, portal[0].p)));
+    if(Vector3DotProduct(dir, portal[0].p) > 0.0f) {
+        SupportPoint swap = portal[1];
+        portal[1] = portal[2];
+        portal[2] = swap;
+        dir = Vector3Negate(dir);
+    }
+
+    for(int iter = 0; iter < MPR_MAX_ITERATIONS; iter ++) {
+        COLLISION_COUNT(mprIterations, 1);
+        portal[3] = GJKSupport(a, supportA, b, supportB, dir);
+        if(Vector3DotProduct(portal[3].p, dir) <= MPR_EPSILON)
+            return -1;
+
+        // origin outside (v1, v0, v3), replace v2
+        float dot = Vector3DotProduct(Vector3CrossProduct(portal[1].p, portal[3].p), portal[0].p);
+        if(dot < -MPR_EPSILON) {
+            portal[2] = portal[3];
+        }
+        else {
+            // origin outside (v3, v0, v2), replace v1
+            dot = Vector3DotProduct(Vector3CrossProduct(portal[3].p, portal[2].p), portal[0].p);
+            if(dot < -MPR_EPSILON)
+                portal[1] = portal[3];
+            else
+                return 0;
+        }
+
+        dir = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(portal[1].p, portal[0].p), Vector3Subtract(portal[2].p, portal[0].p)));
+    }
+
+    return -1;
+}
+
+// push the portal out until the origin is behind it, false if it turns out to be outside
+GJK_INLINE bool MPRRefinePortal(const void * a, SupportFunc supportA, const void * b, SupportFunc supportB, SupportPoint * portal) {
+    for(int iter = 0; iter < MPR_MAX_ITERATIONS; iter ++) {
+        COLLISION_COUNT(mprIterations, 1);
+        Vector3 dir = MPRPortalDir(portal);
+        if(Vector3DotProduct(portal[1].p, dir) >= -MPR_EPSILON)
+            return true;
+
+        SupportPoint v4 = GJKSupport(a, supportA, b, supportB, dir);
+        if(Vector3DotProduct(v4.p, dir) < -MPR_EPSILON || MPRReachedTolerance(portal, v4, dir))
+            return false;
+
+        MPRExpandPortal(portal, v4);
+    }
+    return false;
+}
+
+// penetration estimate, same contract as GJKPenetrationInline
+// the depth is measured to the surface along the portal rather than the true minimum,
+// which is close enough for resolving contacts and a lot cheaper than EPA
+GJK_INLINE Collision MPRPenetrationInline(const void * a, SupportFunc supportA, CenterFunc centerA, const void * b, SupportFunc supportB, CenterFunc centerB) {
+    SupportPoint portal[4];
+    COLLISION_COUNT(mprCalls, 1);
+    int found = MPRDiscoverPortal(a, supportA, centerA, b, supportB, centerB, portal);
+    if(found != 0) {
+        // the origin on portal[0]-portal[1] or touching, libccd's segment case
+        if(found == 2) {
+            float depth = Vector3Length(portal[1].p);
+            return (Collision){ depth > 0.0f, depth, Vector3Normalize(portal[1].p), Vector3Scale(Vector3Add(portal[1].a, portal[1].b), 0.5f) };
+        }
+        return (Collision){ false };
+    }
+
+    if(!MPRRefinePortal(a, supportA, b, supportB, portal))
+        return (Collision){ false };
+
+    for(int iter = 0; iter < MPR_MAX_ITERATIONS; iter ++) {
+        COLLISION_COUNT(mprIterations, 1);
+        Vector3 dir = MPRPortalDir(portal);
+        SupportPoint v4 = GJKSupport(a, supportA, b, supportB, dir);
+        if(MPRReachedTolerance(portal, v4, dir))
+            break;
+        MPRExpandPortal(portal, v4);
+    }
+
+    return PortalResult(portal);
+}
+
+// defines a penetration test between two shapes with both support functions inlined
+#define GJK_PENETRATION(name, supportA, supportB) \
+Collision name(const void * a, const void * b) { \
+    return GJKPenetrationInline(a, supportA, b, supportB); \
+}
+
+// defines an MPR penetration estimate between two shapes
+#define MPR_PENETRATION(name, supportA, centerA, supportB, centerB) \
+Collision name(const void * a, const void * b) { \
+    return MPRPenetrationInline(a, supportA, centerA, b, supportB, centerB); \
+}
+
+// defines a yes/no overlap test between two shapes
+#define GJK_INTERSECT(name, supportA, supportB) \
+bool name(const void * a, const void * b) { \
+    SupportPoint simplex[4]; \
+    int count; \
+    return GJKIntersectInline(a, supportA, b, supportB, simplex, &count); \
+}
+
+#endif
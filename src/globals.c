@@ -0,0 +1,18 @@
+#include "headers.h"
+#include "main.h"
+
+// kept out of main.c so tools can link the game without its main()
+Camera camera = { 0 };
+Vector3 up = { 0.0f, 0.0f, 1.0f };
+Vector3 down = { 0.0f, 0.0f, -1.0f };
+Vector3 north = { 0.0f, 1.0f, 0.0f };
+Vector3 unit_vector = { 1.0f, 1.0f, 1.0f };
+ecs_world_t * world;
+
+ECS_COMPONENT_DECLARE(Position);
+ECS_COMPONENT_DECLARE(CamDistance);
+ECS_COMPONENT_DECLARE(Model);
+ECS_COMPONENT_DECLARE(Matrix);
+ECS_TAG_DECLARE(AssetPending);
+
+Vector3 mouseWorld;
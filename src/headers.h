@@ -3,13 +3,17 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include "memstats.h"     // ahead of raylib.h, it sets RL_MALLOC
 #include "raylib.h"
 #include "raymath.h"
 #include "flecs.h"
 #include "resource_dir.h"
 #include <ccd/ccd.h>
 
-#include "list.h"
+#include "vector.h"
+#include "objpool.h"
+#include "ring.h"
+#include "arena.h"
 #include "boymath.h"
 
 #undef FLT_MAX
@@ -21,6 +25,13 @@
 #define DRAWWIRES 0 
 #define DRAW_SHAPES 0
 #define DRAW_COLLIDER_BOXES 0
+#define USE_LIBCCD 0            // narrowphase through libccd instead of gjk.h
+#define USE_POOL_ALLOCATOR 1    // flecs allocates from allocator.c pools instead of malloc
+#define USE_WORLD_SNAPSHOT 1    // start from snapshot.c's binary world when the glbs haven't changed since it was written
+#define USE_PROFILER 1          // profiler.c timing zones, F3 shows the last frame, F4 writes a chrome trace
+#define USE_WORLD_STATS 1       // F1 shows flecs' world and system stats
+#define USE_COLLISION_COUNTERS 1    // collisionstats.c counts box checks and GJK/EPA/MPR work, published as flecs metrics
+#define USE_MEMORY_STATS 1      // memstats.c bytes per subsystem, F2 shows them and they're printed at exit
 
 #define SIGN(x) (x == 0 ? 0 : x < 0 ? -1 : 1)
 
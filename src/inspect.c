@@ -0,0 +1,49 @@
+#include "inspect.h"
+
+// the stats module's every frame systems, taken out of the pipeline
+#define INSPECT_MONITORS 4
+
+static ecs_entity_t monitors[INSPECT_MONITORS];
+static int monitorCount;
+static float sinceSample;
+static bool started;
+
+static void ThrottleMonitor(ecs_entity_t system) {
+    if(system == 0 || monitorCount == INSPECT_MONITORS)
+        return;
+    ecs_enable(world, system, false);
+    monitors[monitorCount ++] = system;
+}
+
+void StartInspect(uint16_t port) {
+    ECS_IMPORT(world, FlecsStats);
+    monitorCount = 0;
+
+    // the 1 second monitors fill in the frames they skipped from the time they're given, so the explorer's
+    // graphs keep their time axis, just at a coarser step
+    ThrottleMonitor(ecs_lookup_child(world, ecs_id(EcsWorldStats), "Monitor1s"));
+    ThrottleMonitor(ecs_lookup_child(world, ecs_id(EcsPipelineStats), "Monitor1s"));
+    ThrottleMonitor(ecs_lookup_child(world, ecs_id(EcsSystemStats), "Monitor1s"));
+    ThrottleMonitor(ecs_lookup(world, "flecs.stats.UpdateWorldSummary"));
+    if(monitorCount != INSPECT_MONITORS)
+        printf("INSPECT: %d of %d stats monitors found, the rest sample every frame\n", monitorCount, INSPECT_MONITORS);
+
+    ecs_set(world, EcsWorld, EcsRest, { .port = port, .ipaddr = "127.0.0.1" });
+    sinceSample = 0;
+    started = true;
+    printf("INSPECT: flecs explorer on http://127.0.0.1:%d\n", port);
+}
+
+void UpdateInspect(float seconds) {
+    if(!started)
+        return;
+
+    sinceSample += seconds;
+    if(sinceSample < INSPECT_SAMPLE_INTERVAL)
+        return;
+
+    for(int i = 0; i < monitorCount; i ++) {
+        ecs_run(world, monitors[i], sinceSample, NULL);
+    }
+    sinceSample = 0;
+}
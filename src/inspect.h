@@ -0,0 +1,19 @@
+#ifndef _inspect
+#define _inspect
+
+#include "headers.h"
+#include "main.h"
+
+// the flecs explorer (flecs.dev/explorer) attached to a running game or bench: the REST api on loopback
+// only, with the stats module behind it so it has entity counts and system times to show
+
+#define INSPECT_DEFAULT_PORT ECS_REST_DEFAULT_PORT     // 27750, what the explorer looks for
+#define INSPECT_SAMPLE_INTERVAL 0.25    // seconds. flecs' monitors sample every frame, here they're run this often
+
+// after the world's systems are registered
+void StartInspect(uint16_t port);
+
+// once a frame after ecs_progress, with the frame's real time in seconds. does nothing unless started
+void UpdateInspect(float seconds);
+
+#endif
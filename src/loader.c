@@ -0,0 +1,210 @@
+#include "loader.h"
+#include "profiler.h"
+
+DECLARE_RING(LoadJobPtr, LOADER_QUEUE);
+
+// todo and done are shared with the workers, under mutex. the rest is main thread only
+static ecs_os_thread_t threads[LOADER_THREADS];
+static ecs_os_mutex_t mutex;
+static ecs_os_cond_t wake;
+static RING_(LoadJobPtr) todo;
+static RING_(LoadJobPtr) done;
+static bool quitting;
+
+static LoadJob * uploading;
+static int inFlight;
+
+// the part that can run anywhere: file reads, hashing, decoding
+static void PrepareJob(LoadJob * job) {
+    PROFILE_BEGIN(job->path);
+    switch(job->type) {
+        case LOAD_MODEL: {
+            MEMORY_TAG tag = SetRaylibMemoryTag(MEMORY_MESHES);
+            job->prepared = PrepareAssetModel(job->path, &job->asset);
+            SetRaylibMemoryTag(tag);
+            break;
+        }
+        case LOAD_IMAGE: {
+            MEMORY_TAG tag = SetRaylibMemoryTag(MEMORY_IMAGES);
+            job->image = LoadImage(job->path);
+            SetRaylibMemoryTag(tag);
+            job->prepared = job->image.data != NULL;
+            break;
+        }
+    }
+    PROFILE_END();
+}
+
+static void * LoaderThread(void * arg) {
+#if USE_PROFILER
+    ProfileNameThread("loader");
+#endif
+    ecs_os_mutex_lock(mutex);
+    while(true) {
+        while(RING_EMPTY(todo) && !quitting)
+            ecs_os_cond_wait(wake, mutex);
+        if(quitting)
+            break;
+
+        LoadJob * job;
+        RING_POP(todo, job);
+        ecs_os_mutex_unlock(mutex);
+
+        PrepareJob(job);
+
+        ecs_os_mutex_lock(mutex);
+        RING_PUSH(done, job);
+    }
+    ecs_os_mutex_unlock(mutex);
+    return NULL;
+}
+
+void StartLoader(void) {
+    mutex = ecs_os_mutex_new();
+    wake = ecs_os_cond_new();
+    todo = NEWRING(LoadJobPtr);
+    done = NEWRING(LoadJobPtr);
+    quitting = false;
+
+    for(int i = 0; i < LOADER_THREADS; i ++) {
+        threads[i] = ecs_os_thread_new(LoaderThread, NULL);
+    }
+}
+
+// whatever a job holds that nobody took
+static void DropJob(LoadJob * job) {
+    if(job->type == LOAD_MODEL && job->prepared)
+        UnloadAssetModel(&job->asset);
+    if(job->type == LOAD_IMAGE) {
+        UnloadImage(job->image);
+        MemoryCount(MEMORY_TEXTURES, -TEXTURE_BYTES(job->texture));
+        UnloadTexture(job->texture);
+    }
+    HEAP_FREE(job);
+}
+
+void StopLoader(void) {
+    ecs_os_mutex_lock(mutex);
+    quitting = true;
+    ecs_os_cond_broadcast(wake);
+    ecs_os_mutex_unlock(mutex);
+
+    for(int i = 0; i < LOADER_THREADS; i ++) {
+        ecs_os_thread_join(threads[i]);
+    }
+
+    LoadJob * job;
+    while(!RING_EMPTY(todo)) {
+        RING_POP(todo, job);
+        HEAP_FREE(job);
+    }
+    while(!RING_EMPTY(done)) {
+        RING_POP(done, job);
+        DropJob(job);
+    }
+    if(uploading != NULL)
+        DropJob(uploading);
+    uploading = NULL;
+    inFlight = 0;
+
+    ecs_os_cond_free(wake);
+    ecs_os_mutex_free(mutex);
+}
+
+static bool Request(LoadJobType type, const char * path, ecs_entity_t entity, LoadReadyFunc ready, void * ctx) {
+    // the rings only hold LOADER_QUEUE
+    if(inFlight >= LOADER_QUEUE) {
+        printf("LOADER: QUEUE FULL, DROPPED %s\n", path);
+        return false;
+    }
+
+    LoadJob * job = HEAP_ALLOC(MEMORY_GAME, sizeof(LoadJob));
+    *job = (LoadJob){ .type = type, .path = path, .entity = entity, .ready = ready, .ctx = ctx };
+    if(entity != 0)
+        ecs_add_id(world, entity, AssetPending);
+    inFlight ++;
+
+    ecs_os_mutex_lock(mutex);
+    RING_PUSH(todo, job);
+    ecs_os_cond_signal(wake);
+    ecs_os_mutex_unlock(mutex);
+    return true;
+}
+
+bool RequestModel(const char * path, ecs_entity_t entity, LoadReadyFunc ready, void * ctx) {
+    return Request(LOAD_MODEL, path, entity, ready, ctx);
+}
+
+bool RequestImage(const char * path, ecs_entity_t entity, LoadReadyFunc ready, void * ctx) {
+    return Request(LOAD_IMAGE, path, entity, ready, ctx);
+}
+
+// one mesh or texture, true once the job has nothing left to upload
+static bool UploadJobPart(LoadJob * job) {
+    switch(job->type) {
+        case LOAD_MODEL:
+            if(!job->prepared) {
+                // raylib's import uploads as it goes, so a cache miss happens here all at once
+                MEMORY_TAG tag = SetRaylibMemoryTag(MEMORY_MESHES);
+                job->asset = LoadAssetModel(job->path);
+                SetRaylibMemoryTag(tag);
+                job->prepared = true;
+                job->failed = job->asset.model.meshCount == 0;
+                return true;
+            }
+            if(job->part < AssetModelParts(&job->asset))
+                UploadAssetModelPart(&job->asset, job->part ++);
+            return job->part >= AssetModelParts(&job->asset);
+
+        case LOAD_IMAGE:
+            if(job->prepared) {
+                job->texture = LoadTextureFromImage(job->image);
+                MemoryCount(MEMORY_TEXTURES, TEXTURE_BYTES(job->texture));     // whoever keeps it takes it off again
+            }
+            job->failed = job->texture.id == 0;
+            return true;
+    }
+    return true;
+}
+
+static void FinishJob(LoadJob * job) {
+    ecs_entity_t entity = job->entity;
+    if(job->failed)
+        printf("LOADER: COULDN'T LOAD %s\n", job->path);
+
+    if(job->ready != NULL && !job->failed) {
+        job->ready(job);
+        HEAP_FREE(job);
+    }
+    else {
+        DropJob(job);
+    }
+
+    if(entity != 0 && ecs_is_alive(world, entity))
+        ecs_remove_id(world, entity, AssetPending);
+    inFlight --;
+}
+
+void UpdateLoader(double budget) {
+    double start = GetTime();
+    do {
+        if(uploading == NULL) {
+            ecs_os_mutex_lock(mutex);
+            if(!RING_EMPTY(done))
+                RING_POP(done, uploading);
+            ecs_os_mutex_unlock(mutex);
+
+            if(uploading == NULL)
+                return;
+        }
+
+        if(UploadJobPart(uploading)) {
+            FinishJob(uploading);
+            uploading = NULL;
+        }
+    } while(GetTime() - start < budget);
+}
+
+bool LoaderIdle(void) {
+    return inFlight == 0;
+}
@@ -0,0 +1,55 @@
+#ifndef _loader
+#define _loader
+
+#include "headers.h"
+#include "main.h"
+#include "assets.h"
+
+// file reads and decodes on LOADER_THREADS worker threads, gpu uploads back on the main thread a few at a time per frame.
+// the entity a request names carries AssetPending until its ready callback has run
+
+#define LOADER_THREADS 2
+#define LOADER_QUEUE 64                 // requests in flight at once
+#define LOADER_UPLOAD_BUDGET 0.004      // seconds of uploads per frame
+
+typedef enum LoadJobType {
+    LOAD_MODEL,                 // through the asset cache, a miss is imported on the main thread
+    LOAD_IMAGE,                 // LoadImage, then a texture from it
+} LoadJobType;
+
+typedef struct LoadJob LoadJob;
+
+// main thread, once everything is on the gpu. takes ownership of the results. a load that failed is
+// logged and dropped without calling it
+typedef void (*LoadReadyFunc)(LoadJob * job);
+
+struct LoadJob {
+    LoadJobType type;
+    const char * path;          // not copied
+    ecs_entity_t entity;        // 0 for none
+    LoadReadyFunc ready;
+    void * ctx;
+
+    AssetModel asset;           // LOAD_MODEL
+    Image image;                // LOAD_IMAGE
+    Texture2D texture;
+
+    bool prepared;              // what the worker managed, false for a cache miss
+    bool failed;                // no file, or nothing in it
+    int part;                   // next upload
+};
+
+typedef LoadJob * LoadJobPtr;
+
+void StartLoader(void);
+void StopLoader(void);
+
+// false when LOADER_QUEUE requests are already in flight, nothing is queued then
+bool RequestModel(const char * path, ecs_entity_t entity, LoadReadyFunc ready, void * ctx);
+bool RequestImage(const char * path, ecs_entity_t entity, LoadReadyFunc ready, void * ctx);
+
+// main thread, once a frame
+void UpdateLoader(double budget);
+bool LoaderIdle(void);
+
+#endif
@@ -3,22 +3,24 @@
 #include "models.h"
 #include "actors.h"
 #include "collision.h"
+#include "allocator.h"
+#include "snapshot.h"
+#include "assets.h"
+#include "loader.h"
+#include "atlas.h"
+#include "profiler.h"
+#include "worldstats.h"
+#include "inspect.h"
+#include "collisionstats.h"
+#include "replay.h"
+#include "rlgl.h"
+#include <time.h>
 
 float GetRandomFloat(int min, int max, int precision) {
     float f = GetRandomValue(min*precision, max*precision);
     return f / precision;
 }
 
-// global
-Camera camera = { 0 };
-Vector3 up = { 0.0f, 0.0f, 1.0f };
-Vector3 down = { 0.0f, 0.0f, -1.0f };
-Vector3 north = { 0.0f, 1.0f, 0.0f };
-Vector3 unit_vector = { 1.0f, 1.0f, 1.0f };
-ecs_world_t * world;
-
-Vector3 mouseWorld;
-
 float Timer = 0;
 
 typedef struct Billboard {
@@ -29,9 +31,7 @@ typedef struct Billboard {
     Color tint;
 } Billboard;
 
-typedef struct CamDistance {
-    float dist;
-} CamDistance;
+ECS_COMPONENT_DECLARE(Billboard);
 
 void SetCamDistance(ecs_iter_t * it) {
     CamDistance * cd = ecs_field(it, CamDistance, 0);
@@ -52,25 +52,188 @@ int CompareCamDistance(ecs_entity_t e1, const void * v1, ecs_entity_t e2, const
 
 ecs_entity_t Billboards[SPRITE_COUNT];
 
-DECLARE_PLIST(Image);
-DECLARE_PLIST(Texture2D);
+// newest of the files the world is built from, a snapshot made from any other version of them gets rebuilt.
+// the map's uvs are squeezed into a sprites.atlas region before it's saved, so the sheet counts too
+int64_t WorldSourceStamp(void) {
+    const char * sources[] = { "map1.glb", "Cop.glb", "sprites.png", "sprites.atlas" };
+    long newest = 0;
+    for(int i = 0; i < (int)(sizeof(sources) / sizeof(sources[0])); i ++) {
+        long stamp = GetFileModTime(sources[i]);
+        if(stamp > newest)
+            newest = stamp;
+    }
+    return newest;
+}
+
+DECLARE_VECTOR(Image, 8);
+DECLARE_VECTOR(Texture2D, 8);
+
+// what the loader callbacks fill in. the map is finished once both it and the sprite sheet are in
+static struct {
+    // lists for removing when done
+    VECTOR_(Image) images;
+    VECTOR_(Texture2D) textures;
+
+    Atlas sprites;              // regions up front, the texture when the loader has it
+    bool spritesReady;
+
+    AssetModel mapAsset;
+    AssetModel copAsset;
+    ecs_entity_t mapEntity;
+    ecs_entity_t cop2Entity;
+    bool mapReady;
+} load;
+
+static void FinishMap(void) {
+    if(!load.spritesReady || !load.mapReady)
+        return;
+
+    SetModelMaterialAtlas(&load.mapAsset.model, 0, &load.sprites, "plain");
+    Model model_map = load.mapAsset.model;
+
+    // coliders
+    Matrix matIdentitiy = MatrixIdentity();
+    MeshCollider * mapColliders = GetAssetMeshCollidersArena(FrameArena(), &load.mapAsset, matIdentitiy);
+
+    for(int i = 0; i < model_map.meshCount; i ++) {
+        ecs_entity_t collider = ecs_new(world);
+        ecs_set_ptr(world, collider, MeshCollider, &mapColliders[i]);
+    }
+
+    // create billboard guys, one bulk spawn per type. after the colliders so they have something to land on
+    int typeCounts[SPRITE_PURPLE + 1] = { 0 };
+    for(int i = 0; i < ACTOR_COUNT; i ++) {
+        typeCounts[GetRandomValue(SPRITE_RED, SPRITE_PURPLE)] ++;
+    }
+
+    Position spawnPositions[ACTOR_COUNT];
+    for(int bb = SPRITE_RED; bb <= SPRITE_PURPLE; bb ++) {
+        for(int i = 0; i < typeCounts[bb]; i ++) {
+            spawnPositions[i] = (Position){ GetRandomFloat(-7.5, 7.5, 1000), GetRandomFloat(-7.5, 7.5, 1000), 8.0f };
+        }
+        SpawnActors(Billboards[bb], bb, spawnPositions, typeCounts[bb], NULL);
+    }
+}
+
+// sprites.atlas region for each actor type
+static const char * spriteRegions[SPRITE_PURPLE + 1] = { "red", "yellow", "green", "purple" };
+
+static void SpritesReady(LoadJob * job) {
+    // everything draws out of the one texture, the image isn't needed once it's uploaded
+    load.sprites.texture = job->texture;
+    UnloadImage(job->image);
+
+    // a snapshot's map was saved bound to a region, it gets the texture back here
+    if(job->ctx != NULL)
+        BindSnapshotAtlas(job->ctx, &load.sprites);
+
+    // instances share their prefab's Billboard, so every actor of a type picks this up at once
+    for(int i = SPRITE_RED; i <= SPRITE_PURPLE; i ++) {
+        ecs_set(world, Billboards[i], Billboard, {
+            &load.sprites.texture,                          // tex
+            GetAtlasRegion(&load.sprites, spriteRegions[i]), // source
+            (Vector2){ 1.0f, 1.0f },                        // size
+            (Vector2){ 0.5, 0},                             // origin
+            WHITE,                                          // tint
+
+        });
+    }
+
+    load.spritesReady = true;
+    FinishMap();
+}
+
+static void MapReady(LoadJob * job) {
+    load.mapAsset = job->asset;
+    ecs_set_ptr(world, job->entity, Model, &load.mapAsset.model);
+
+    load.mapReady = true;
+    FinishMap();
+}
+
+static void CopReady(LoadJob * job) {
+    load.copAsset = job->asset;
+    ecs_set_ptr(world, job->entity, Model, &load.copAsset.model);
+    ecs_set_ptr(world, load.cop2Entity, Model, &load.copAsset.model);
+    ecs_remove(world, load.cop2Entity, AssetPending);
+}
 
-int main () {
+int main (int argc, char ** argv) {
+
+    // --rest [port] serves the world to the flecs explorer on 127.0.0.1
+    // --record [file] records input from the actors' first tick to exit for stress_bench --replay, into resources/
+    // --seed N spawns the same actors as the run that used it, the seed is printed and recorded
+    // either of the last two spawns from the map, not from world.snapshot, and leaves the snapshot alone
+    int restPort = 0;
+    const char * recordPath = NULL;
+    uint32_t seed = (uint32_t)time(NULL);
+    bool seeded = false;
+    for(int i = 1; i < argc; i ++) {
+        if(strcmp(argv[i], "--rest") == 0) {
+            restPort = INSPECT_DEFAULT_PORT;
+            if(i + 1 < argc && atoi(argv[i + 1]) > 0)
+                restPort = atoi(argv[++ i]);
+        }
+        else if(strcmp(argv[i], "--record") == 0) {
+            recordPath = REPLAY_PATH;
+            if(i + 1 < argc && argv[i + 1][0] != '-')
+                recordPath = argv[++ i];
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++ i], NULL, 10);
+            seeded = true;
+        }
+        else {
+            printf("usage: %s [--rest [port]] [--record [file]] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+#if USE_POOL_ALLOCATOR
+    ecs_os_set_api_defaults();
+    InstallPoolAllocator();
+#endif
+#if USE_MEMORY_STATS
+    // over the pool, before anything has gone through either
+    ecs_os_set_api_defaults();
+    InstallMemoryStats();
+    bool showMemory = false;
+#endif
+#if USE_PROFILER
+    // needs the os api for its locks, does nothing when the pool allocator already set it up
+    ecs_os_set_api_defaults();
+    StartProfiler();
+    bool showProfiler = false;
+#endif
 
 	world = ecs_init();
 
 	ECS_COMPONENT(world, Vector3);
-	ECS_COMPONENT(world, Position);
-    ECS_COMPONENT(world, Billboard);
-    ECS_COMPONENT(world, CamDistance);
-    ECS_COMPONENT(world, Matrix);
-    ECS_COMPONENT(world, Actor);
-    ECS_COMPONENT(world, Model);
+	ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Billboard);
+    ecs_add_pair(world, ecs_id(Billboard), EcsOnInstantiate, EcsInherit);
+    ECS_COMPONENT_DEFINE(world, CamDistance);
+    ECS_COMPONENT_DEFINE(world, Matrix);
+    ECS_ACTOR_COMPONENTS();
+    ECS_COMPONENT_DEFINE(world, Model);
+
+    ECS_ASSET_PENDING();
 
     ECS_COLLIDER_COMPONENTS();
     ECS_COLLIDER_QUERIES();
+    ECS_COLLIDER_SYSTEMS();
 
     ECS_SYSTEM(world, SetCamDistance, EcsOnUpdate, CamDistance, Position);
+#if USE_COLLISION_COUNTERS
+    RegisterCollisionMetrics();
+#endif
+
+#if USE_WORLD_STATS
+    StartWorldStats();
+#endif
+    if(restPort > 0) {
+        StartInspect((uint16_t)restPort);
+    }
 
 
 	// Tell the window to use vsync and work on high DPI displays
@@ -78,6 +241,10 @@ int main () {
 
 	// Create the window and OpenGL context
 	InitWindow(1280, 800, "flecs Test");
+    // after InitWindow, which seeds from the clock
+    SetRandomSeed(seed);
+    printf("SEED %u\n", seed);
+    StartLoader();
 
 	// Utility function from resource_dir.h to find the resources folder and set it as the current working directory so we can load from it
 	SearchAndSetResourceDir("resources");
@@ -92,88 +259,97 @@ int main () {
 	SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
 
     // textures
-    // lists for removing when done
-    PLIST_(Image) images = NEWPLIST(Image);
-    PLIST_(Texture2D) textures = NEWPLIST(Texture2D);
-
-	Image fullimage = LoadImage("sprites.png");
-    Texture2D fulltex = LoadTextureFromImage(fullimage);
-	Image img_plain = ImageFromImage(fullimage, (Rectangle){ 16*4, 16*2, 16, 16 });
-	Texture2D tex_plain = LoadTextureFromImage(img_plain);
-    Image img_brick = ImageFromImage(fullimage, (Rectangle){ 16*2, 16*2, 16, 16 });
-	Texture2D tex_brick = LoadTextureFromImage(img_brick);
+    load.images = NEWVECTOR(Image);
+    load.textures = NEWVECTOR(Texture2D);
 
+    MEMORY_TAG tag = SetRaylibMemoryTag(MEMORY_IMAGES);
     Image img_sky = GenImageChecked(256, 256, 16, 16, BLACK, BLUE);
+    SetRaylibMemoryTag(tag);
     Texture2D tex_sky = LoadTextureFromImage(img_sky);
+    MemoryCount(MEMORY_TEXTURES, TEXTURE_BYTES(tex_sky));
 
-    LIST_ADD(images, &fullimage);
-    LIST_ADD(textures, &fulltex);
-    LIST_ADD(images, &img_plain);
-    LIST_ADD(textures, &tex_plain);
-    LIST_ADD(images, &img_brick);
-    LIST_ADD(textures, &tex_brick);
-    LIST_ADD(images, &img_sky);
-    LIST_ADD(textures, &tex_sky);
+    VECTOR_PUSH(load.images, img_sky);
+    VECTOR_PUSH(load.textures, tex_sky);
 
     // models
-    ecs_query_t * q_Models = ecs_query(world, {
-        .terms = {
-            { ecs_id(Model) }
-        },
-    });
-
     ecs_query_t * q_ModelMatrix = ecs_query(world, {
         .terms = {
-            { ecs_id(Model) }, { ecs_id(Matrix) }
+            { ecs_id(Model) }, { ecs_id(Matrix) }, { AssetPending, .oper = EcsNot }
         },
     });
 
-    Matrix matIdentitiy = MatrixIdentity();
-
-    // plain
-    printf("LOAD MAP\n");
-    Model model_map = LoadModel("map1.glb");
-	model_map.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = tex_plain;
-
-    ecs_entity_t map_entity = ecs_new(world);
-    ecs_set_ptr(world, map_entity, Model, &model_map);
-    ecs_set_ptr(world, map_entity, Matrix, &matIdentitiy);
-
-    // coliders
-    MeshCollider * mapColliders = GetModelMeshColliders(model_map, &matIdentitiy);
+    // prefabs before the world, a snapshot's actors are stored against them
+    // small actors share one shape through this prefab
+    ecs_entity_t smallActor = ecs_entity(world, {
+        .add = ecs_ids( EcsPrefab )
+    });
+    ecs_set(world, smallActor, ActorShape, { { -ACTOR_SMALL_R, -ACTOR_SMALL_R, 0 }, { ACTOR_SMALL_R, ACTOR_SMALL_R, ACTOR_SMALL_H } });
 
-    for(int i = 0; i < model_map.meshCount; i ++) {
-        ecs_entity_t collider = ecs_new(world);
-        ecs_set_ptr(world, collider, MeshCollider, &mapColliders[i]);
+    // sprite billboard prefabs, their Billboard comes with the sprite sheet
+    for(int i = SPRITE_RED; i <= SPRITE_PURPLE; i ++) {
+        Billboards[i] = ecs_entity(world, {
+            .add = ecs_ids( EcsPrefab, ecs_isa(smallActor) )
+        });
     }
 
-    free(mapColliders);
-
-    // cop
-    Model model_cop = LoadModel("Cop.glb");
-    ecs_entity_t cop_entity = ecs_new(world);
-    ecs_set_ptr(world, cop_entity, Model, &model_cop);
-    ecs_set_ptr(world, cop_entity, Matrix, &matIdentitiy);
-
-    ecs_entity_t cop2_entity = ecs_new(world);
-    ecs_set_ptr(world, cop2_entity, Model, &model_cop);
-    Matrix matCop2 = MatrixMultiply(matIdentitiy, MatrixTranslate(1.0f, 0.0f, 0.0f));
-    ecs_set_ptr(world, cop2_entity, Matrix, &matCop2);
+    Matrix matIdentitiy = MatrixIdentity();
 
-    // skybox
-    printf("LOAD SKYBOX\n");
-    Model model_skybox = LoadModelFromMesh(GenMeshInvertedCube(16, 16, 16));
-	model_skybox.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = tex_sky;
+    double loadStart = GetTime();
+    int64_t sourceStamp = WorldSourceStamp();
+    WorldSnapshot snapshot = { 0 };
+    Model model_skybox = { 0 };
+    bool fromSnapshot = false;
+#if USE_WORLD_SNAPSHOT && !DRAW_SHAPES
+    // the snapshot's actors would stand in for the seeded spawn
+    bool freshSpawn = seeded || recordPath != NULL;
+    if(!freshSpawn) {
+        tag = SetRaylibMemoryTag(MEMORY_MESHES);
+        fromSnapshot = LoadWorldSnapshot(WORLD_SNAPSHOT_PATH, sourceStamp, &snapshot, Billboards, SPRITE_PURPLE + 1);
+        SetRaylibMemoryTag(tag);
+    }
+#endif
 
-    ecs_entity_t skybox_entity = ecs_new(world);
-    ecs_set_ptr(world, skybox_entity, Model, &model_skybox);
-    //ecs_set_ptr(world, skybox_entity, Matrix, &matIdentitiy);
+    printf("LOAD SPRITES\n");
+    if(!LoadAtlasRegions("sprites.atlas", &load.sprites))
+        printf("COULDN'T READ sprites.atlas\n");
+    RequestImage("sprites.png", 0, SpritesReady, fromSnapshot ? &snapshot : NULL);
+
+    if(!fromSnapshot) {
+        // plain
+        printf("LOAD MAP\n");
+        load.mapEntity = ecs_new(world);
+        ecs_set_ptr(world, load.mapEntity, Matrix, &matIdentitiy);
+        RequestModel("map1.glb", load.mapEntity, MapReady, NULL);
+
+        // cop
+        ecs_entity_t cop_entity = ecs_new(world);
+        ecs_set_ptr(world, cop_entity, Matrix, &matIdentitiy);
+
+        load.cop2Entity = ecs_new(world);
+        Matrix matCop2 = MatrixMultiply(matIdentitiy, MatrixTranslate(1.0f, 0.0f, 0.0f));
+        ecs_set_ptr(world, load.cop2Entity, Matrix, &matCop2);
+        ecs_add(world, load.cop2Entity, AssetPending);      // CopReady fills in both
+        RequestModel("Cop.glb", cop_entity, CopReady, NULL);
+
+        // skybox
+        printf("LOAD SKYBOX\n");
+        tag = SetRaylibMemoryTag(MEMORY_MESHES);
+        model_skybox = LoadModelFromMesh(GenMeshInvertedCube(16, 16, 16));
+        SetRaylibMemoryTag(tag);
+        model_skybox.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = tex_sky;
+
+        ecs_entity_t skybox_entity = ecs_new(world);
+        ecs_set_ptr(world, skybox_entity, Model, &model_skybox);
+        //ecs_set_ptr(world, skybox_entity, Matrix, &matIdentitiy);
+    }
+    // the rest arrives through UpdateLoader, WORLD READY is printed once it's all in
+    bool worldReady = false;
 
 #if DRAW_SHAPES
     // icosphere
     Model model_icosphere = LoadModel("icosphere.glb");
     Matrix ico_transform = MatrixTranslate(0, 0, 4);
-    MeshCollider ico_collider = GetModelMeshCollider0(model_icosphere, &ico_transform);
+    MeshCollider ico_collider = GetModelMeshCollider0(model_icosphere, ico_transform);
 
     ecs_entity_t ico_entity = ecs_new(world);
     ecs_set_ptr(world, ico_entity, Model, &model_icosphere);
@@ -184,7 +360,7 @@ int main () {
     // cylinder
     Model model_cylinder = LoadModel("cylinder.glb");
     Matrix cyl_transform = MatrixTranslate(-4, 0, 4);
-    MeshCollider cyl_collider = GetModelMeshCollider0(model_cylinder, &cyl_transform);
+    MeshCollider cyl_collider = GetModelMeshCollider0(model_cylinder, cyl_transform);
 
     ecs_entity_t cyl_entity = ecs_new(world);
     ecs_set_ptr(world, cyl_entity, Model, &model_cylinder);
@@ -197,43 +373,9 @@ int main () {
     ecs_set_ptr(world, box_entity, BoxCollider, &box);
 #endif
 
-    // sprite billboard prefabs
-    for(int i = SPRITE_RED; i <= SPRITE_PURPLE; i ++) {
-        float tilew = ((float)fulltex.width)/8.0f;
-        float tileh = ((float)fulltex.height)/8.0f;
-        Billboards[i] = ecs_entity(world, {
-            .add = ecs_ids( EcsPrefab )
-        });
-        ecs_set(world, Billboards[i], Billboard, {
-            &fulltex,                                       // tex
-            (Rectangle){ i * tilew, 0.0f, tilew, tileh},    // source
-            (Vector2){ 1.0f, 1.0f },                        // size
-            (Vector2){ 0.5, 0},                             // origin
-            WHITE,                                          // tint
-
-        });
-    }
-
-    BoxCollider smallActorBox = { { -ACTOR_SMALL_R, -ACTOR_SMALL_R, 0 }, { ACTOR_SMALL_R, ACTOR_SMALL_R, ACTOR_SMALL_H } };
-
-    // create billboard guys
-    for(int i = 0; i < ACTOR_COUNT; i ++) {
-        int bb = GetRandomValue(SPRITE_RED, SPRITE_PURPLE);
-        ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, Billboards[bb]);
-        ecs_set(world, inst, CamDistance, { 0 });
-        ecs_set(world, inst, Actor, { .type = bb, .box = &smallActorBox, .groundNormal = up });
-        float x = GetRandomFloat(-7.5, 7.5, 1000);
-        float y = GetRandomFloat(-7.5, 7.5, 1000);
-        float z = GetElevation(x, y, 8.0f);
-        if(z == FLT_MAX)
-            z = 0.0f;
-
-        ecs_set(world, inst, Position, { x, y, z });
-    }
-
     ecs_query_t * q_billboards = ecs_query(world, {
         .terms = {
-            { ecs_id(Billboard) }, { ecs_id(Position) }, { ecs_id(CamDistance) }
+            { ecs_id(Billboard) }, { ecs_id(Position) }, { ecs_id(CamDistance) }, { AssetPending, .oper = EcsNot }
         },
         .order_by = ecs_id(CamDistance),
         .order_by_callback = (ecs_order_by_action_t)CompareCamDistance,
@@ -241,10 +383,20 @@ int main () {
 
     ecs_query_t * q_actors = ecs_query(world, {
         .terms = {
-            { ecs_id(Actor) }, { ecs_id(Position) }
+            { ecs_id(Position) }, { ecs_id(Velocity) }, { ecs_id(GroundState) }, { ecs_id(ContactManifold) },
+            { ecs_id(ActorShape), .inout = EcsIn }
         }
     });
 
+#if USE_WORLD_STATS
+    AddWorldStatsQuery("models", q_ModelMatrix);
+    AddWorldStatsQuery("billboards", q_billboards);
+    AddWorldStatsQuery("actors", q_actors);
+#endif
+
+    // actor state for the recording's checksums
+    ecs_query_t * q_checksum = recordPath != NULL ? ActorChecksumQuery() : NULL;
+
     Vector2 mousePos = GetMousePosition();
     Vector2 lastMousePos = mousePos;
 
@@ -255,9 +407,35 @@ int main () {
         mousePos = GetMousePosition();
         Vector2 mouseDelta = Vector2Subtract(mousePos, lastMousePos);
 
+        PROFILE_BEGIN("UpdateLoader");
+        UpdateLoader(LOADER_UPLOAD_BUDGET);
+        PROFILE_END();
+        if(!worldReady && LoaderIdle()) {
+            worldReady = true;
+#if USE_WORLD_SNAPSHOT && !DRAW_SHAPES
+            // a failed load leaves the world without its map or the cop, that isn't worth keeping
+            bool complete = load.mapReady && load.spritesReady && load.copAsset.model.meshCount > 0;
+            if(!fromSnapshot && !freshSpawn && complete && !SaveWorldSnapshot(WORLD_SNAPSHOT_PATH, sourceStamp, &load.sprites, Billboards, SPRITE_PURPLE + 1))
+                printf("COULDN'T WRITE %s\n", WORLD_SNAPSHOT_PATH);
+#endif
+            printf("WORLD READY IN %.1f ms FROM %s\n", (GetTime() - loadStart) * 1000.0, fromSnapshot ? "SNAPSHOT" : "GLTF");
+        }
+
         float dt = GetFrameTime() * 60.0;
         Timer += dt;
-        ecs_progress(world, dt);
+#if USE_COLLISION_COUNTERS
+        // last frame's picks and actor moves, for the metrics this progress updates
+        UpdateCollisionStats();
+#endif
+
+        // flecs gets seconds, its timers and the explorer's stats go by them
+        PROFILE_BEGIN("ecs_progress");
+        ecs_progress(world, GetFrameTime());
+        PROFILE_END();
+        UpdateInspect(GetFrameTime());
+#if USE_WORLD_STATS
+        UpdateWorldStats();
+#endif
 
         Vector3 camOffset = Vector3Subtract(camera.position, camera.target);
 
@@ -307,8 +485,10 @@ int main () {
         keymove = Vector2Normalize(keymove);
         keymove = Vector2Rotate(keymove, camAngle);
 
+        PROFILE_BEGIN("mouse pick");
         Ray mouseRay = GetScreenToWorldRay(mousePos, camera);
         RayCollision mouseHit = RayToAnyCollider(mouseRay, FLT_MAX);
+        PROFILE_END();
         mouseWorld = mouseHit.point;
 		
 		// Draw
@@ -327,9 +507,7 @@ int main () {
                     MeshCollider * colliders = ecs_field(&it_collider, MeshCollider, 0);
 
                     for(int i = 0; i < it_collider.count; i ++) {
-                        MeshCollider collider = colliders[i];
-                        BoundingBox bbox = TransformBoundingBox(collider.box, *collider.transform);
-                        DrawBoundingBox(bbox, RED);
+                        DrawBoundingBox(colliders[i].worldBox, RED);
 
                     }
                 }
@@ -347,7 +525,7 @@ int main () {
                 
                 //cyl_transform = MatrixMultiply(cyl_transform, MatrixTranslate(keymove.x * 0.1, keymove.y * 0.1, 0));
                 DrawBoundingBox(box, WHITE);
-                BoundingBox cyl_box = TransformBoundingBox(cyl_collider.box, *cyl_collider.transform);
+                BoundingBox cyl_box = cyl_collider.worldBox;
                 DrawBoundingBox(cyl_box, WHITE);
                 
                 //Collision c = MeshCollision(cyl_collider, ico_collider);
@@ -367,6 +545,7 @@ int main () {
 #endif
 
                 // draw models
+                PROFILE_BEGIN("draw models");
                 ecs_iter_t it = ecs_query_iter(world, q_ModelMatrix);
                 while(ecs_query_next(&it)) {
                     Model *models = ecs_field(&it, Model, 0);
@@ -382,6 +561,7 @@ int main () {
 #endif
                     }
                 }
+                PROFILE_END();
 
                 if(mouseHit.hit) {
                     DrawCube(mouseHit.point, 0.3f, 0.3f, 0.3f, WHITE);
@@ -391,15 +571,18 @@ int main () {
                 }
 				
                 // draw billboards
+                PROFILE_BEGIN("draw billboards");
                 it = ecs_query_iter(world, q_billboards);
 
                 while(ecs_query_next(&it)) {
                     Billboard *b = ecs_field(&it, Billboard, 0);
                     Position *p = ecs_field(&it, Position, 1);
+                    bool sharedBillboard = !ecs_field_is_self(&it, 0);     // normally comes from the prefab
 
                     // inner loop
                     for (int i = 0; i < it.count; i ++) {
-                        DrawBillboardPro(camera, *b[i].tex, b[i].source, p[i], up, b[i].size, b[i].origin, 0.0f, b[i].tint);
+                        const Billboard * bb = sharedBillboard ? &b[0] : &b[i];
+                        DrawBillboardPro(camera, *bb->tex, bb->source, p[i], up, bb->size, bb->origin, 0.0f, bb->tint);
 
 #if DRAWWIRES
                         // Billboard position
@@ -407,60 +590,155 @@ int main () {
 #endif
                     }
                 }
+                PROFILE_END();
 
                 // actor movement
+#if DEBUG
+                int64_t simHeapAllocs = HeapAllocCount();
+#endif
+                bool jump = IsKeyPressed(KEY_SPACE);
+
+                // starts on the tick the actors show up, before they've moved
+                if(recordPath != NULL && !Recording() && ecs_query_is_true(q_actors)) {
+                    if(!StartRecording(recordPath, seed, GetFileModTime("map1.glb"), Billboards, SPRITE_PURPLE + 1))
+                        printf("COULDN'T WRITE %s\n", recordPath);
+                    recordPath = NULL;
+                }
+
                 it = ecs_query_iter(world, q_actors);
 
                 while(ecs_query_next(&it)) {
-                    Actor *a = ecs_field(&it, Actor, 0);
-                    Position *p = ecs_field(&it, Position, 1);
-
-                    // inner loop
-                    for (int i = 0; i < it.count; i ++) {
-                        ActorPhysics( &a[i], &p[i], keymove );
-                    }
+                    ActorPhysics(&it, keymove, jump);
                 }
+#if DEBUG
+                // collision temporaries come from the frame arena, so physics shouldn't touch the heap. an arena
+                // that ran out falls back to it until the next reset grows it, that's worth a line but not a stop
+                int64_t physicsAllocs = HeapAllocCount() - simHeapAllocs;
+                if(physicsAllocs != 0)
+                    printf("PHYSICS HEAP ALLOCS: %lld (arena peak %zu)\n", (long long)physicsAllocs, FrameArena()->peak);
+#endif
+                if(Recording())
+                    RecordTick(keymove, jump, mouseRay, ActorChecksum(q_checksum));
 
 			EndMode3D();
 		
 			DrawFPS(10, 10);
+#if USE_PROFILER
+            if(showProfiler)
+                DrawProfiler(10, 40, GetScreenWidth() - 20);
+#endif
+#if USE_WORLD_STATS
+            if(WorldStatsShown())
+                DrawWorldStats(GetScreenWidth() - 470, 10);
+#endif
+#if USE_MEMORY_STATS
+            if(showMemory)
+                DrawMemoryStats(10, GetScreenHeight() - 10);
+#endif
 		
+            // waits out vsync
+            PROFILE_BEGIN("EndDrawing");
 		EndDrawing();
+            PROFILE_END();
         //----------------------------------------------------------------------------------
 
         if(IsKeyPressed(KEY_F12)) {
             TakeScreenshot("Screenshots/1.png");
         }
 
+#if USE_WORLD_SNAPSHOT && !DRAW_SHAPES
+        // keep the world as it is now, actors and all, for the next start
+        if(IsKeyPressed(KEY_F5) && worldReady) {
+            SaveWorldSnapshot(WORLD_SNAPSHOT_PATH, sourceStamp, &load.sprites, Billboards, SPRITE_PURPLE + 1);
+        }
+#endif
+
+#if USE_WORLD_STATS
+        if(IsKeyPressed(KEY_F1)) {
+            ShowWorldStats(!WorldStatsShown());
+        }
+#endif
+#if USE_MEMORY_STATS
+        if(IsKeyPressed(KEY_F2)) {
+            showMemory = !showMemory;
+        }
+#endif
+#if USE_PROFILER
+        if(IsKeyPressed(KEY_F3)) {
+            showProfiler = !showProfiler;
+        }
+        if(IsKeyPressed(KEY_F4)) {
+            if(!WriteProfileTrace(PROFILE_TRACE_PATH))
+                printf("COULDN'T WRITE %s\n", PROFILE_TRACE_PATH);
+        }
+#endif
+
         lastMousePos = mousePos;
 
         // end of frame
+        FrameArenaReset();
+#if DEBUG
+        ReportFrameHeapAllocs();
+#endif
+        PROFILE_FRAME();
 	}
 
 	// cleanup
 
+    // drops whatever is still in flight
+    StopLoader();
+    StopRecording();
+#if USE_WORLD_STATS
+    StopWorldStats();
+#endif
+#if USE_PROFILER
+    StopProfiler();
+#endif
+
     // TODO: unload images, textures, and models
-    for(int i = 0; i < textures.size; i ++) {
-        UnloadTexture(*LIST_GET(textures, i));
+    for(int i = 0; i < load.textures.size; i ++) {
+        MemoryCount(MEMORY_TEXTURES, -TEXTURE_BYTES(VECTOR_GET(load.textures, i)));
+        UnloadTexture(VECTOR_GET(load.textures, i));
     }
-    for(int i = 0; i < images.size; i ++) {
-        UnloadImage(*LIST_GET(images, i));
+    for(int i = 0; i < load.images.size; i ++) {
+        UnloadImage(VECTOR_GET(load.images, i));
     }
-
-    ecs_iter_t it = ecs_query_iter(world, q_Models);
-    while(ecs_query_next(&it)) {
-        Model *models = ecs_field(&it, Model, 0);
-        // inner loop
-        for(int i = 0; i < it.count; i ++) {
-            Model model = models[i];
-            UnloadModel(models[i]); // CAUSES ERROR BECAUSE MODEL MAY ALREADY BE UNLOADED
-        }
+    FREEVECTOR(load.textures);
+    FREEVECTOR(load.images);
+    // ahead of the map, whose material only borrows the sheet
+    UnloadAtlas(&load.sprites);
+
+    // each model once, however many entities share it
+    if(fromSnapshot) {
+        UnloadWorldSnapshot(&snapshot);
+    }
+    else {
+        UnloadAssetModel(&load.mapAsset);
+        UnloadAssetModel(&load.copAsset);
+        // tex_sky went with load.textures above, UnloadMaterial skips the default texture
+        model_skybox.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = (Texture2D){ rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        UnloadModel(model_skybox);
     }
+#if DRAW_SHAPES
+    UnloadModel(model_icosphere);
+    UnloadModel(model_cylinder);
+#endif
 
     // destroy the window and cleanup the OpenGL context
 	CloseWindow();
 
 	ecs_fini(world);
 
+#if USE_POOL_ALLOCATOR && DEBUG
+    PrintPoolStats();
+#endif
+#if USE_MEMORY_STATS
+    // what's left is what nothing freed
+    PrintMemoryStats();
+#endif
+#if USE_POOL_ALLOCATOR
+    FreePoolAllocator();
+#endif
+
 	return 0;
 }
\ No newline at end of file
@@ -5,11 +5,29 @@
 
 extern Vector3 up;
 extern Vector3 down;
+extern Vector3 north;
 extern Vector3 unit_vector;
 extern Camera camera;
 extern ecs_world_t * world;
 typedef Vector3 Position;
 
+typedef struct CamDistance {
+    float dist;
+} CamDistance;
+
+// defined in main(), declared here so other modules can use them
+extern ECS_COMPONENT_DECLARE(Position);
+extern ECS_COMPONENT_DECLARE(CamDistance);
+extern ECS_COMPONENT_DECLARE(Model);
+extern ECS_COMPONENT_DECLARE(Matrix);
+
+// on entities whose assets are still loading (loader.c), inherited through IsA. drawing and collision skip them
+extern ECS_TAG_DECLARE(AssetPending);
+
+#define ECS_ASSET_PENDING() \
+ECS_TAG_DEFINE(world, AssetPending); \
+ecs_add_pair(world, AssetPending, EcsOnInstantiate, EcsInherit)
+
 extern Vector3 mouseWorld;
 
 #define q_(suffix) q_##suffix
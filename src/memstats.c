@@ -0,0 +1,218 @@
+#include "memstats.h"
+#include "headers.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MEMORY_ADD(ptr, n) (_InterlockedExchangeAdd64((volatile long long *)(ptr), (n)) + (n))
+#define MEMORY_CAS(ptr, expected, value) (_InterlockedCompareExchange64((volatile long long *)(ptr), (value), (expected)) == (expected))
+#else
+#define MEMORY_ADD(ptr, n) __atomic_add_fetch((ptr), (n), __ATOMIC_RELAXED)
+#define MEMORY_CAS(ptr, expected, value) __atomic_compare_exchange_n((ptr), &(int64_t){ (expected) }, (value), false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#endif
+
+#define MEMORY_HEADER_SIZE 16           // keeps blocks 16 byte aligned, like the pool's
+#define MEMORY_MAGIC 0x4d454d53         // "MEMS", catches a block that didn't come from here
+
+typedef struct MemoryHeader {
+    int64_t size;
+    int32_t tag;
+    uint32_t magic;
+} MemoryHeader;
+
+_Static_assert(sizeof(MemoryHeader) == MEMORY_HEADER_SIZE, "MemoryHeader has to stay one alignment step");
+
+static const char * tagNames[MEMORY_TAG_COUNT] = {
+    "flecs", "raylib", "meshes", "images", "textures", "mapped", "colliders", "lists", "arenas", "game"
+};
+
+static MemoryTagStats stats[MEMORY_TAG_COUNT];
+static THREAD_LOCAL MEMORY_TAG raylibTag = MEMORY_RAYLIB;
+
+// what was in the os api before us, the pool allocator or flecs' own
+static ecs_os_api_malloc_t nextMalloc;
+static ecs_os_api_calloc_t nextCalloc;
+static ecs_os_api_realloc_t nextRealloc;
+static ecs_os_api_free_t nextFree;
+
+void MemoryCount(MEMORY_TAG tag, int64_t bytes) {
+#if USE_MEMORY_STATS
+    MemoryTagStats * s = &stats[tag];
+    int64_t now = MEMORY_ADD(&s->bytes, bytes);
+    if(bytes > 0)
+        MEMORY_ADD(&s->allocs, 1);
+
+    int64_t peak = s->peak;
+    while(now > peak && !MEMORY_CAS(&s->peak, peak, now)) {
+        peak = s->peak;
+    }
+#else
+    (void)tag;
+    (void)bytes;
+#endif
+}
+
+#if USE_MEMORY_STATS
+// raw is MEMORY_HEADER_SIZE bigger than size
+static void * TrackBlock(MEMORY_TAG tag, void * raw, size_t size) {
+    if(raw == NULL)
+        return NULL;
+    *(MemoryHeader *)raw = (MemoryHeader){ (int64_t)size, tag, MEMORY_MAGIC };
+    MemoryCount(tag, (int64_t)size);
+    return (char *)raw + MEMORY_HEADER_SIZE;
+}
+
+// the block's header, uncounted
+static MemoryHeader * UntrackBlock(void * ptr) {
+    MemoryHeader * header = (MemoryHeader *)((char *)ptr - MEMORY_HEADER_SIZE);
+    assert(header->magic == MEMORY_MAGIC);
+    MemoryCount(header->tag, -header->size);
+    return header;
+}
+#endif
+
+void * MemoryAlloc(MEMORY_TAG tag, size_t size) {
+#if USE_MEMORY_STATS
+    return TrackBlock(tag, malloc(MEMORY_HEADER_SIZE + size), size);
+#else
+    (void)tag;
+    return malloc(size);
+#endif
+}
+
+void * MemoryCalloc(MEMORY_TAG tag, size_t count, size_t size) {
+#if USE_MEMORY_STATS
+    return TrackBlock(tag, calloc(1, MEMORY_HEADER_SIZE + count * size), count * size);
+#else
+    (void)tag;
+    return calloc(count, size);
+#endif
+}
+
+void * MemoryRealloc(MEMORY_TAG tag, void * ptr, size_t size) {
+#if USE_MEMORY_STATS
+    if(ptr == NULL)
+        return MemoryAlloc(tag, size);
+    MemoryHeader * header = UntrackBlock(ptr);
+    MEMORY_TAG blockTag = header->tag;
+    void * raw = realloc(header, MEMORY_HEADER_SIZE + size);
+    if(raw == NULL) {
+        MemoryCount(blockTag, header->size);    // still there, still counted
+        return NULL;
+    }
+    return TrackBlock(blockTag, raw, size);
+#else
+    (void)tag;
+    return realloc(ptr, size);
+#endif
+}
+
+void MemoryFree(void * ptr) {
+#if USE_MEMORY_STATS
+    if(ptr != NULL)
+        free(UntrackBlock(ptr));
+#else
+    free(ptr);
+#endif
+}
+
+MEMORY_TAG SetRaylibMemoryTag(MEMORY_TAG tag) {
+    MEMORY_TAG previous = raylibTag;
+    raylibTag = tag;
+    return previous;
+}
+
+MEMORY_TAG RaylibMemoryTag(void) {
+    return raylibTag;
+}
+
+#if USE_MEMORY_STATS
+static void * FlecsMalloc(ecs_size_t size) {
+    return TrackBlock(MEMORY_FLECS, nextMalloc(MEMORY_HEADER_SIZE + size), size);
+}
+
+static void * FlecsCalloc(ecs_size_t size) {
+    return TrackBlock(MEMORY_FLECS, nextCalloc(MEMORY_HEADER_SIZE + size), size);
+}
+
+static void * FlecsRealloc(void * ptr, ecs_size_t size) {
+    if(ptr == NULL)
+        return FlecsMalloc(size);
+    MemoryHeader * header = UntrackBlock(ptr);
+    return TrackBlock(MEMORY_FLECS, nextRealloc(header, MEMORY_HEADER_SIZE + size), size);
+}
+
+static void FlecsFree(void * ptr) {
+    if(ptr != NULL)
+        nextFree(UntrackBlock(ptr));
+}
+#endif
+
+void InstallMemoryStats(void) {
+#if USE_MEMORY_STATS
+    // straight into ecs_os_api, ecs_os_set_api only takes the first call
+    nextMalloc = ecs_os_api.malloc_;
+    nextCalloc = ecs_os_api.calloc_;
+    nextRealloc = ecs_os_api.realloc_;
+    nextFree = ecs_os_api.free_;
+    ecs_os_api.malloc_ = FlecsMalloc;
+    ecs_os_api.calloc_ = FlecsCalloc;
+    ecs_os_api.realloc_ = FlecsRealloc;
+    ecs_os_api.free_ = FlecsFree;
+#endif
+}
+
+MemoryTagStats GetMemoryStats(MEMORY_TAG tag) {
+    return stats[tag];
+}
+
+const char * MemoryTagName(MEMORY_TAG tag) {
+    return tagNames[tag];
+}
+
+static const char * FormatBytes(int64_t bytes) {
+    if(bytes >= 10 * 1024 * 1024 || bytes <= -10 * 1024 * 1024)
+        return TextFormat("%.1f MB", bytes / (1024.0 * 1024.0));
+    return TextFormat("%.1f KB", bytes / 1024.0);
+}
+
+void DrawMemoryStats(int x, int y) {
+    const int line = 12;
+    const int fontSize = 10;
+    const int height = line * (MEMORY_TAG_COUNT + 2) + 8;
+
+    y -= height;
+    DrawRectangle(x, y, 300, height, Fade(BLACK, 0.7f));
+    int ty = y + 4;
+    DrawText("memory         in use          peak      allocs   F2 hide", x + 4, ty, fontSize, WHITE);
+    ty += line;
+
+    int64_t total = 0;
+    int64_t totalPeak = 0;
+    for(int i = 0; i < MEMORY_TAG_COUNT; i ++) {
+        MemoryTagStats s = GetMemoryStats(i);
+        total += s.bytes;
+        totalPeak += s.peak;
+        DrawText(tagNames[i], x + 4, ty, fontSize, LIGHTGRAY);
+        DrawText(FormatBytes(s.bytes), x + 80, ty, fontSize, WHITE);
+        DrawText(FormatBytes(s.peak), x + 150, ty, fontSize, WHITE);
+        DrawText(TextFormat("%lld", (long long)s.allocs), x + 220, ty, fontSize, WHITE);
+        ty += line;
+    }
+    // peaks came at different times, so theirs is an upper bound
+    DrawText("total", x + 4, ty, fontSize, LIGHTGRAY);
+    DrawText(FormatBytes(total), x + 80, ty, fontSize, WHITE);
+    DrawText(FormatBytes(totalPeak), x + 150, ty, fontSize, WHITE);
+}
+
+void PrintMemoryStats(void) {
+    printf("%10s %14s %14s %10s\n", "memory", "in use", "peak", "allocs");
+    int64_t total = 0;
+    int64_t totalPeak = 0;
+    for(int i = 0; i < MEMORY_TAG_COUNT; i ++) {
+        MemoryTagStats s = GetMemoryStats(i);
+        total += s.bytes;
+        totalPeak += s.peak;
+        printf("%10s %14lld %14lld %10lld\n", tagNames[i], (long long)s.bytes, (long long)s.peak, (long long)s.allocs);
+    }
+    printf("%10s %14lld %14lld\n", "total", (long long)total, (long long)totalPeak);
+}
@@ -0,0 +1,66 @@
+#ifndef _memstats
+#define _memstats
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// bytes in use and peak per subsystem. kept free of headers.h: raylib's own sources get it force included
+// (build/premake5.lua) so its RL_MALLOC lands here too, and headers.h includes it ahead of raylib.h so ours does.
+// heap blocks carry a small header with their size and tag, so whatever frees them needn't know either.
+// gpu textures and mapped files aren't heap, their owners count them by hand with MemoryCount
+
+typedef enum {
+    MEMORY_FLECS,               // everything flecs asks its os api for: tables, queries, commands...
+    MEMORY_RAYLIB,              // raylib's RL_MALLOC outside the scopes below
+    MEMORY_MESHES,              // model cpu data, while SetRaylibMemoryTag says so
+    MEMORY_IMAGES,              // decoded pixels waiting for upload
+    MEMORY_TEXTURES,            // gpu, estimated from size and format
+    MEMORY_MAPPED,              // snapshot and asset cache files
+    MEMORY_COLLIDERS,
+    MEMORY_LISTS,               // vector.h and objpool.h storage
+    MEMORY_ARENAS,
+    MEMORY_GAME,                // the rest of ours
+
+    MEMORY_TAG_COUNT,
+} MEMORY_TAG;
+
+typedef struct MemoryTagStats {
+    int64_t bytes;              // what was asked for, headers not included
+    int64_t peak;
+    int64_t allocs;             // total, ever
+} MemoryTagStats;
+
+void * MemoryAlloc(MEMORY_TAG tag, size_t size);
+void * MemoryCalloc(MEMORY_TAG tag, size_t count, size_t size);
+// a block keeps its first tag through reallocs
+void * MemoryRealloc(MEMORY_TAG tag, void * ptr, size_t size);
+void MemoryFree(void * ptr);
+
+// bytes held some other way, negative when they're let go
+void MemoryCount(MEMORY_TAG tag, int64_t bytes);
+
+// what this thread's raylib allocations count as, returns the one before
+MEMORY_TAG SetRaylibMemoryTag(MEMORY_TAG tag);
+MEMORY_TAG RaylibMemoryTag(void);
+
+#define RL_MALLOC(size) MemoryAlloc(RaylibMemoryTag(), (size))
+#define RL_CALLOC(count, size) MemoryCalloc(RaylibMemoryTag(), (count), (size))
+#define RL_REALLOC(ptr, size) MemoryRealloc(RaylibMemoryTag(), (ptr), (size))
+#define RL_FREE(ptr) MemoryFree(ptr)
+
+// a texture's share of MEMORY_TEXTURES, mipmaps add a third
+#define TEXTURE_BYTES(texture) ((int64_t)GetPixelDataSize((texture).width, (texture).height, (texture).format) * \
+    ((texture).mipmaps > 1 ? 4 : 3) / 3)
+
+// after InstallPoolAllocator and before anything allocates through flecs, chains onto its os api
+void InstallMemoryStats(void);
+
+MemoryTagStats GetMemoryStats(MEMORY_TAG tag);
+const char * MemoryTagName(MEMORY_TAG tag);
+
+// the F2 overlay, its bottom left corner at x, y
+void DrawMemoryStats(int x, int y);
+void PrintMemoryStats(void);
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef _objpool
+#define _objpool
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "memstats.h"
+
+// objects in one array with a free list through the empty slots.
+// handles carry a generation so a handle to a freed (or reused) slot is caught instead of aliasing.
+// the array can move when it grows, so hold handles, not pointers, across allocations
+
+typedef struct Handle {
+    int32_t index;
+    uint32_t generation;        // odd while the slot is alive
+} Handle;
+
+#define NULL_HANDLE (Handle){ -1, 0 }
+
+typedef struct ObjPoolCore {
+    uint32_t * generations;
+    int32_t * nextFree;
+    int capacity;
+    int count;
+    int freeHead;
+} ObjPoolCore;
+
+#define OBJPOOL_(T) T##_ObjPool
+
+#define DECLARE_OBJPOOL(T) typedef struct OBJPOOL_(T) { \
+    union { T * items; void * data; }; \
+    ObjPoolCore core; \
+} OBJPOOL_(T)
+
+#define NEWOBJPOOL(T) (OBJPOOL_(T)){ .core = { .freeHead = -1 } }
+
+#define OBJPOOL_RESERVE(P, n) ObjPoolGrow(&(P).data, &(P).core, (n), sizeof(*(P).items))
+#define OBJPOOL_ALLOC(P) ObjPoolAlloc(&(P).data, &(P).core, sizeof(*(P).items))
+#define OBJPOOL_FREE(P, h) ObjPoolFree(&(P).core, (h))
+#define OBJPOOL_VALID(P, h) ObjPoolValid(&(P).core, (h))
+
+// NULL for a stale handle
+#define OBJPOOL_GET(P, h) (OBJPOOL_VALID(P, h) ? &(P).items[(h).index] : NULL)
+
+// for walking every live object: for(int i = 0; i < P.core.capacity; i ++) if(OBJPOOL_ALIVE(P, i)) ...
+#define OBJPOOL_ALIVE(P, i) ((P).core.generations[i] & 1)
+
+#define FREEOBJPOOL(P) do { \
+    MemoryFree((P).items); \
+    MemoryFree((P).core.generations); \
+    MemoryFree((P).core.nextFree); \
+    (P).items = NULL; \
+    (P).core = (ObjPoolCore){ .freeHead = -1 }; \
+} while(0)
+
+static inline void ObjPoolGrow(void ** data, ObjPoolCore * core, int needed, size_t esize) {
+    if(needed <= core->capacity)
+        return;
+
+    int newCapacity = core->capacity ? core->capacity : 8;
+    while(newCapacity < needed)
+        newCapacity *= 2;
+
+    *data = MemoryRealloc(MEMORY_LISTS, *data, esize * newCapacity);
+    core->generations = MemoryRealloc(MEMORY_LISTS, core->generations, sizeof(uint32_t) * newCapacity);
+    core->nextFree = MemoryRealloc(MEMORY_LISTS, core->nextFree, sizeof(int32_t) * newCapacity);
+    assert(*data && core->generations && core->nextFree);
+
+    // chain the new slots onto the free list, lowest index first
+    for(int i = newCapacity - 1; i >= core->capacity; i --) {
+        core->generations[i] = 0;
+        core->nextFree[i] = core->freeHead;
+        core->freeHead = i;
+    }
+    core->capacity = newCapacity;
+}
+
+static inline Handle ObjPoolAlloc(void ** data, ObjPoolCore * core, size_t esize) {
+    if(core->freeHead < 0)
+        ObjPoolGrow(data, core, core->capacity + 1, esize);
+
+    int32_t index = core->freeHead;
+    core->freeHead = core->nextFree[index];
+    core->generations[index] ++;
+    core->count ++;
+
+    return (Handle){ index, core->generations[index] };
+}
+
+static inline bool ObjPoolValid(const ObjPoolCore * core, Handle h) {
+    return h.index >= 0 && h.index < core->capacity && core->generations[h.index] == h.generation && (h.generation & 1);
+}
+
+static inline void ObjPoolFree(ObjPoolCore * core, Handle h) {
+    assert(ObjPoolValid(core, h));
+
+    core->generations[h.index] ++;
+    core->nextFree[h.index] = core->freeHead;
+    core->freeHead = h.index;
+    core->count --;
+}
+
+#endif
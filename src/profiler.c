@@ -0,0 +1,294 @@
+#include "profiler.h"
+
+DECLARE_RING(ProfileEvent, PROFILE_RING_EVENTS);
+
+typedef struct ProfileThread {
+    int id;
+    const char * name;
+    ecs_os_mutex_t lock;        // the owner only holds it for a push, so the trace can copy the ring safely
+    RING_(ProfileEvent) events;
+    ProfileEvent open[PROFILE_MAX_DEPTH];
+    int depth;
+    int skipped;                // begins past PROFILE_MAX_DEPTH, their ends are skipped too
+} ProfileThread;
+
+// one bar in the overlay, a zone or a run of the same zone back to back
+typedef struct FrameBar {
+    const char * name;
+    int64_t start;
+    int64_t end;
+    int64_t busy;               // sum of the merged zones, end - start includes the gaps between them
+    int depth;
+    int count;
+} FrameBar;
+
+static THREAD_LOCAL ProfileThread * thread;
+static ProfileThread * threads[PROFILE_MAX_THREADS];
+static int threadCount;
+static ecs_os_mutex_t threadsLock;
+static bool started;
+
+static ProfileThread * mainThread;
+static int64_t frameStart;
+static FrameBar frameBars[PROFILE_FRAME_BARS];
+static int frameBarCount;
+static int64_t lastFrameStart;
+static int64_t lastFrameEnd;
+
+static ProfileThread * ProfileThisThread(void) {
+    if(thread != NULL || !started)
+        return thread;
+
+    ecs_os_mutex_lock(threadsLock);
+    if(threadCount < PROFILE_MAX_THREADS) {
+        // profiler bookkeeping, not counted as game heap
+        thread = calloc(1, sizeof(ProfileThread));
+        thread->id = threadCount;
+        thread->name = "thread";
+        thread->lock = ecs_os_mutex_new();
+        threads[threadCount ++] = thread;
+    }
+    ecs_os_mutex_unlock(threadsLock);
+    return thread;
+}
+
+// flecs reports its own internals too (commits, table creation), only the systems are wanted
+static bool IsFlecsInternal(const char * name) {
+    return name == NULL || strncmp(name, "flecs.", 6) == 0;
+}
+
+static void TracePush(const char * file, size_t line, const char * name) {
+    if(!IsFlecsInternal(name))
+        ProfileBegin(name);
+}
+
+static void TracePop(const char * file, size_t line, const char * name) {
+    if(!IsFlecsInternal(name))
+        ProfileEnd();
+}
+
+void StartProfiler(void) {
+    threadsLock = ecs_os_mutex_new();
+    started = true;
+
+    mainThread = ProfileThisThread();
+    ProfileNameThread("main");
+    frameStart = ecs_os_now();
+
+    // straight into the api, ecs_os_set_api only takes the first one set and the pool allocator may have been first
+    ecs_os_api.perf_trace_push_ = TracePush;
+    ecs_os_api.perf_trace_pop_ = TracePop;
+}
+
+// the other threads have to be done with their zones by now
+void StopProfiler(void) {
+    ecs_os_api.perf_trace_push_ = NULL;
+    ecs_os_api.perf_trace_pop_ = NULL;
+
+    started = false;
+    for(int i = 0; i < threadCount; i ++) {
+        ecs_os_mutex_free(threads[i]->lock);
+        free(threads[i]);
+        threads[i] = NULL;
+    }
+    threadCount = 0;
+    thread = NULL;
+    mainThread = NULL;
+    ecs_os_mutex_free(threadsLock);
+}
+
+void ProfileNameThread(const char * name) {
+    ProfileThread * t = ProfileThisThread();
+    if(t != NULL)
+        t->name = name;
+}
+
+void ProfileBegin(const char * name) {
+    ProfileThread * t = ProfileThisThread();
+    if(t == NULL)
+        return;
+
+    if(t->depth == PROFILE_MAX_DEPTH) {
+        t->skipped ++;
+        return;
+    }
+    t->open[t->depth] = (ProfileEvent){ name, ecs_os_now(), 0, t->depth };
+    t->depth ++;
+}
+
+void ProfileEnd(void) {
+    ProfileThread * t = ProfileThisThread();
+    if(t == NULL)
+        return;
+
+    if(t->skipped > 0) {
+        t->skipped --;
+        return;
+    }
+    assert(t->depth > 0);
+    if(t->depth == 0)
+        return;
+
+    t->depth --;
+    ProfileEvent event = t->open[t->depth];
+    event.end = ecs_os_now();
+
+    ecs_os_mutex_lock(t->lock);
+    RING_PUSH_OVERWRITE(t->events, event);
+    ecs_os_mutex_unlock(t->lock);
+}
+
+// the main thread's zones that ended this frame, loops of the same zone folded into one bar
+void ProfileFrame(void) {
+    if(mainThread == NULL)
+        return;
+
+    int64_t now = ecs_os_now();
+    RING_(ProfileEvent) * events = &mainThread->events;
+
+    // zones are pushed as they end, so this frame's are at the back
+    int first = events->count;
+    while(first > 0 && RING_GET(*events, first - 1).end >= frameStart) {
+        first --;
+    }
+
+    frameBarCount = 0;
+    for(int i = first; i < events->count; i ++) {
+        ProfileEvent e = RING_GET(*events, i);
+
+        // a repeat follows its last run directly, anything nested inside them ended in between
+        int match = -1;
+        for(int b = frameBarCount - 1; b >= 0 && frameBars[b].depth >= e.depth; b --) {
+            if(frameBars[b].depth == e.depth) {
+                if(frameBars[b].name == e.name || strcmp(frameBars[b].name, e.name) == 0)
+                    match = b;
+                break;
+            }
+        }
+
+        if(match >= 0) {
+            frameBars[match].end = e.end;
+            frameBars[match].busy += e.end - e.start;
+            frameBars[match].count ++;
+        }
+        else if(frameBarCount < PROFILE_FRAME_BARS) {
+            frameBars[frameBarCount ++] = (FrameBar){ e.name, e.start, e.end, e.end - e.start, e.depth, 1 };
+        }
+    }
+
+    lastFrameStart = frameStart;
+    lastFrameEnd = now;
+    frameStart = now;
+}
+
+static Color ZoneColor(const char * name) {
+    unsigned hash = 2166136261u;
+    for(const char * c = name; *c; c ++) {
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    }
+    return ColorFromHSV((float)(hash % 360), 0.55f, 0.85f);
+}
+
+void DrawProfiler(int x, int y, int width) {
+    const int rowHeight = 14;
+    const int fontSize = 10;
+
+    int depth = 0;
+    for(int i = 0; i < frameBarCount; i ++) {
+        if(frameBars[i].depth + 1 > depth)
+            depth = frameBars[i].depth + 1;
+    }
+
+    double frameNs = (double)(lastFrameEnd - lastFrameStart);
+    DrawRectangle(x, y, width, rowHeight * (depth + 1) + 4, Fade(BLACK, 0.7f));
+    DrawText(TextFormat("frame %.2f ms   F3 hide   F4 write %s", frameNs / 1e6, PROFILE_TRACE_PATH), x + 2, y + 2, fontSize, WHITE);
+    if(frameNs <= 0)
+        return;
+
+    // deepest last so the labels of parents don't cover their children
+    for(int i = 0; i < frameBarCount; i ++) {
+        FrameBar bar = frameBars[i];
+        int bx = x + (int)((bar.start - lastFrameStart) / frameNs * width);
+        int bw = (int)((bar.end - bar.start) / frameNs * width);
+        int by = y + rowHeight * (bar.depth + 1) + 2;
+        if(bw < 1)
+            bw = 1;
+        if(bx < x)
+            bx = x;
+
+        DrawRectangle(bx, by, bw, rowHeight - 1, ZoneColor(bar.name));
+
+        const char * label = bar.count > 1 ? TextFormat("%s x%d %.2f", bar.name, bar.count, bar.busy / 1e6)
+            : TextFormat("%s %.2f", bar.name, bar.busy / 1e6);
+        if(MeasureText(label, fontSize) + 4 <= bw)
+            DrawText(label, bx + 2, by + 2, fontSize, BLACK);
+    }
+}
+
+// loader zones are named after file paths, which can hold backslashes and quotes
+static void WriteJsonString(FILE * file, const char * s) {
+    fputc('"', file);
+    for(const unsigned char * c = (const unsigned char *)s; *c; c ++) {
+        if(*c == '"' || *c == '\\')
+            fprintf(file, "\\%c", *c);
+        else if(*c < 0x20)
+            fprintf(file, "\\u%04x", *c);
+        else
+            fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+// chrome's trace event format, complete events in microseconds
+bool WriteProfileTrace(const char * path) {
+    FILE * file = fopen(path, "w");
+    if(file == NULL)
+        return false;
+
+    // copied out under each thread's lock so the file isn't written with it held
+    ProfileEvent * copy = malloc(sizeof(ProfileEvent) * PROFILE_RING_EVENTS);
+    int64_t origin = INT64_MAX;
+    bool first = true;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    ecs_os_mutex_lock(threadsLock);
+    for(int pass = 0; pass < 2; pass ++) {
+        for(int t = 0; t < threadCount; t ++) {
+            ProfileThread * pt = threads[t];
+
+            ecs_os_mutex_lock(pt->lock);
+            int count = pt->events.count;
+            for(int i = 0; i < count; i ++) {
+                copy[i] = RING_GET(pt->events, i);
+            }
+            ecs_os_mutex_unlock(pt->lock);
+
+            // first pass finds where the trace starts, the second writes it
+            if(pass == 0) {
+                for(int i = 0; i < count; i ++) {
+                    if(copy[i].start < origin)
+                        origin = copy[i].start;
+                }
+                continue;
+            }
+
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                first ? "" : ",\n", pt->id);
+            WriteJsonString(file, pt->name);
+            fprintf(file, "}}");
+            first = false;
+            for(int i = 0; i < count; i ++) {
+                fprintf(file, ",\n{\"name\":");
+                WriteJsonString(file, copy[i].name);
+                fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    pt->id, (copy[i].start - origin) / 1e3, (copy[i].end - copy[i].start) / 1e3);
+            }
+        }
+    }
+    ecs_os_mutex_unlock(threadsLock);
+    fprintf(file, "\n]}\n");
+
+    free(copy);
+    bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,49 @@
+#ifndef _profiler
+#define _profiler
+
+#include "headers.h"
+
+// nested timing zones. each thread records finished zones into its own ring, the main thread's last frame
+// is drawn as a flame graph by DrawProfiler and every ring can be written out as a chrome trace
+// (chrome://tracing or ui.perfetto.dev). with USE_PROFILER 0 the macros compile to nothing
+
+#define PROFILE_RING_EVENTS 16384       // per thread, oldest are dropped
+#define PROFILE_MAX_DEPTH 32
+#define PROFILE_MAX_THREADS 8
+#define PROFILE_FRAME_BARS 512          // what the overlay keeps of one frame, after merging repeats
+#define PROFILE_TRACE_PATH "profile_trace.json"
+
+#if USE_PROFILER
+#define PROFILE_BEGIN(name) ProfileBegin(name)
+#define PROFILE_END() ProfileEnd()
+#define PROFILE_FRAME() ProfileFrame()
+#else
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
+
+typedef struct ProfileEvent {
+    const char * name;          // not copied, string literals or names that outlive the profiler
+    int64_t start;              // ns, ecs_os_now
+    int64_t end;
+    int32_t depth;
+} ProfileEvent;
+
+// main thread, after ecs_os_set_api_defaults and before anything is timed. also routes flecs' per system
+// perf trace into zones when flecs is built with FLECS_PERF_TRACE
+void StartProfiler(void);
+void StopProfiler(void);
+
+// name shows in the trace, call from the thread itself before its first zone
+void ProfileNameThread(const char * name);
+
+void ProfileBegin(const char * name);
+void ProfileEnd(void);
+// main thread, once a frame at the end. keeps the frame for DrawProfiler
+void ProfileFrame(void);
+
+void DrawProfiler(int x, int y, int width);
+bool WriteProfileTrace(const char * path);
+
+#endif
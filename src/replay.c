@@ -0,0 +1,305 @@
+#include "replay.h"
+
+static FILE * recording;
+static const char * recordingPath;
+static bool recordingFailed;   // a short write, the disk is full or gone
+static ReplayHeader recordHeader;
+static ReplayTick lastTick;
+
+static void RecordWrite(const void * data, size_t size, size_t count) {
+    if(fwrite(data, size, count, recording) != count)
+        recordingFailed = true;
+}
+
+static int WriteActorColumn(ecs_query_t * q, int field, size_t size) {
+    int count = 0;
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while(ecs_query_next(&it)) {
+        RecordWrite(ecs_field_w_size(&it, size, field), size, it.count);
+        count += it.count;
+    }
+    return count;
+}
+
+bool StartRecording(const char * path, uint32_t seed, int64_t mapStamp, const ecs_entity_t * prefabs, int prefabCount) {
+    recording = fopen(path, "wb");
+    if(recording == NULL)
+        return false;
+    recordingPath = path;
+    recordingFailed = false;
+
+    recordHeader = (ReplayHeader){ .magic = REPLAY_MAGIC, .version = REPLAY_VERSION, .mapStamp = mapStamp, .seed = seed, .prefabCount = prefabCount };
+    RecordWrite(&recordHeader, sizeof(recordHeader), 1);
+
+    // a group per prefab, laid out like the snapshot's
+    for(int p = 0; p < prefabCount; p ++) {
+        ecs_query_t * q = ecs_query(world, {
+            .terms = {
+                { ecs_id(ActorType) }, { ecs_id(Position) }, { ecs_id(Velocity) }, { ecs_id(GroundState) },
+                { ecs_pair(EcsIsA, prefabs[p]) }
+            }
+        });
+
+        ReplayActorGroup group = { .prefab = p, .count = ecs_query_count(q).entities };
+        if(group.count > 0) {
+            RecordWrite(&group, sizeof(group), 1);
+            WriteActorColumn(q, 0, sizeof(ActorType));
+            WriteActorColumn(q, 1, sizeof(Position));
+            WriteActorColumn(q, 2, sizeof(Velocity));
+            WriteActorColumn(q, 3, sizeof(GroundState));
+            recordHeader.actorGroupCount ++;
+        }
+        ecs_query_fini(q);
+    }
+
+    // without its actors a replay is no use, don't leave one behind
+    if(recordingFailed) {
+        fclose(recording);
+        remove(path);
+        recording = NULL;
+        return false;
+    }
+
+    lastTick = (ReplayTick){ 0 };
+    return true;
+}
+
+void RecordTick(Vector2 move, bool jump, Ray pick, uint64_t checksum) {
+    if(recording == NULL)
+        return;
+
+    // compared bit for bit, a replay has to get exactly what the game got
+    uint8_t flags = REPLAY_CHECKSUM;
+    if(memcmp(&move, &lastTick.move, sizeof(move)) != 0)
+        flags |= REPLAY_MOVE;
+    if(memcmp(&pick, &lastTick.pick, sizeof(pick)) != 0)
+        flags |= REPLAY_PICK;
+    if(jump)
+        flags |= REPLAY_JUMP;
+
+    RecordWrite(&flags, 1, 1);
+    if(flags & REPLAY_MOVE)
+        RecordWrite(&move, sizeof(move), 1);
+    if(flags & REPLAY_PICK)
+        RecordWrite(&pick, sizeof(pick), 1);
+    RecordWrite(&checksum, sizeof(checksum), 1);
+
+    // stop there. the header only counts whole ticks, so the torn one at the end is never read
+    if(recordingFailed) {
+        StopRecording();
+        return;
+    }
+
+    lastTick.move = move;
+    lastTick.pick = pick;
+    recordHeader.tickCount ++;
+}
+
+void StopRecording(void) {
+    if(recording == NULL)
+        return;
+
+    // a failed tick still gets its header patched if the file allows it, the ticks before it are fine
+    bool cutShort = recordingFailed;
+    recordingFailed = false;
+    if(fseek(recording, 0, SEEK_SET) == 0)
+        RecordWrite(&recordHeader, sizeof(recordHeader), 1);
+    else
+        recordingFailed = true;
+    if(fclose(recording) != 0)
+        recordingFailed = true;
+    recording = NULL;
+
+    if(recordingFailed)
+        printf("REPLAY: COULDN'T WRITE %s, it won't play back\n", recordingPath);
+    else if(cutShort)
+        printf("REPLAY: COULDN'T WRITE %s, kept the first %d ticks\n", recordingPath, recordHeader.tickCount);
+    else
+        printf("REPLAY: recorded %d ticks\n", recordHeader.tickCount);
+}
+
+bool Recording(void) {
+    return recording != NULL;
+}
+
+static size_t ReplayGroupSize(ReplayActorGroup g) {
+    return sizeof(ReplayActorGroup) + (size_t)g.count * (sizeof(ActorType) + sizeof(Position) + sizeof(Velocity) + sizeof(GroundState));
+}
+
+// unpacks into ticks, or only counts with NULL. a tick cut short by a crash is dropped
+static int DecodeTicks(const uint8_t * p, const uint8_t * end, ReplayTick * ticks) {
+    ReplayTick tick = { 0 };
+    int count = 0;
+    while(p < end) {
+        uint8_t flags = *p ++;
+        size_t size = ((flags & REPLAY_MOVE) ? sizeof(Vector2) : 0) + ((flags & REPLAY_PICK) ? sizeof(Ray) : 0) +
+            ((flags & REPLAY_CHECKSUM) ? sizeof(uint64_t) : 0);
+        if((size_t)(end - p) < size)
+            break;
+
+        if(flags & REPLAY_MOVE) {
+            memcpy(&tick.move, p, sizeof(Vector2));
+            p += sizeof(Vector2);
+        }
+        if(flags & REPLAY_PICK) {
+            memcpy(&tick.pick, p, sizeof(Ray));
+            p += sizeof(Ray);
+        }
+        tick.jump = flags & REPLAY_JUMP;
+        tick.checked = flags & REPLAY_CHECKSUM;
+        if(tick.checked) {
+            memcpy(&tick.checksum, p, sizeof(uint64_t));
+            p += sizeof(uint64_t);
+        }
+
+        if(ticks != NULL)
+            ticks[count] = tick;
+        count ++;
+    }
+    return count;
+}
+
+bool LoadReplay(const char * path, Replay * replay) {
+    *replay = (Replay){ 0 };
+    FILE * file = fopen(path, "rb");
+    if(file == NULL)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    replay->data = malloc(size > 0 ? size : 1);
+    bool ok = size >= (long)sizeof(ReplayHeader) && fread(replay->data, 1, size, file) == (size_t)size;
+    fclose(file);
+
+    if(ok) {
+        memcpy(&replay->header, replay->data, sizeof(ReplayHeader));
+        ok = replay->header.magic == REPLAY_MAGIC && replay->header.version == REPLAY_VERSION;
+    }
+    if(!ok) {
+        printf("REPLAY: %s isn't a version %d recording\n", path, REPLAY_VERSION);
+        UnloadReplay(replay);
+        return false;
+    }
+
+    const uint8_t * p = replay->data + sizeof(ReplayHeader);
+    const uint8_t * end = replay->data + size;
+    for(int i = 0; i < replay->header.actorGroupCount && ok; i ++) {
+        ReplayActorGroup g;
+        ok = (size_t)(end - p) >= sizeof(g);
+        if(ok) {
+            memcpy(&g, p, sizeof(g));
+            ok = g.count >= 0 && g.prefab >= 0 && g.prefab < replay->header.prefabCount && (size_t)(end - p) >= ReplayGroupSize(g);
+        }
+        if(ok) {
+            p += ReplayGroupSize(g);
+            replay->actorCount += g.count;
+        }
+    }
+    if(!ok) {
+        printf("REPLAY: %s is cut short in its actors\n", path);
+        UnloadReplay(replay);
+        return false;
+    }
+
+    // the whole recording unpacked up front, so playing it back is only the simulation
+    int tickCount = DecodeTicks(p, end, NULL);
+    if(tickCount != replay->header.tickCount)
+        printf("REPLAY: %s has %d ticks, its header says %d. it wasn't stopped cleanly\n", path, tickCount, replay->header.tickCount);
+    replay->header.tickCount = tickCount;
+    replay->ticks = malloc(sizeof(ReplayTick) * (tickCount > 0 ? tickCount : 1));
+    DecodeTicks(p, end, replay->ticks);
+    return true;
+}
+
+bool InsertReplayActors(const Replay * replay, const ecs_entity_t * prefabs, int prefabCount) {
+    if(replay->header.prefabCount > prefabCount) {
+        printf("REPLAY: recorded with %d prefabs, given %d\n", replay->header.prefabCount, prefabCount);
+        return false;
+    }
+
+    const uint8_t * p = replay->data + sizeof(ReplayHeader);
+    for(int i = 0; i < replay->header.actorGroupCount; i ++) {
+        ReplayActorGroup g;
+        memcpy(&g, p, sizeof(g));
+        const uint8_t * types = p + sizeof(g);
+        const uint8_t * positions = types + sizeof(ActorType) * g.count;
+        const uint8_t * velocities = positions + sizeof(Position) * g.count;
+        const uint8_t * grounds = velocities + sizeof(Velocity) * g.count;
+
+        InsertActors(prefabs[g.prefab], (const ActorType *)types, (const Position *)positions, (const Velocity *)velocities,
+            (const GroundState *)grounds, g.count, NULL);
+        p += ReplayGroupSize(g);
+    }
+    return true;
+}
+
+void UnloadReplay(Replay * replay) {
+    free(replay->data);
+    free(replay->ticks);
+    *replay = (Replay){ 0 };
+}
+
+ecs_query_t * ActorChecksumQuery(void) {
+    return ecs_query(world, {
+        .terms = {
+            { ecs_id(ActorType), .inout = EcsIn }, { ecs_id(Position), .inout = EcsIn },
+            { ecs_id(Velocity), .inout = EcsIn }, { ecs_id(GroundState), .inout = EcsIn }
+        }
+    });
+}
+
+uint64_t ChecksumWords(uint64_t h, const void * data, size_t size) {
+    const uint32_t * words = data;
+    for(size_t i = 0; i < size / sizeof(uint32_t); i ++) {
+        h = (h ^ words[i]) * CHECKSUM_PRIME;
+    }
+    return h;
+}
+
+static uint64_t ActorHash(const ActorType * type, const Position * position, const Velocity * velocity, const GroundState * ground) {
+    uint64_t h = CHECKSUM_BASIS;
+    h = ChecksumWords(h, type, sizeof(ActorType));
+    h = ChecksumWords(h, position, sizeof(Position));
+    h = ChecksumWords(h, velocity, sizeof(Velocity));
+    h = ChecksumWords(h, ground, sizeof(GroundState));
+    return h;
+}
+
+uint64_t ActorChecksum(ecs_query_t * query) {
+    uint64_t sum = 0;
+    ecs_iter_t it = ecs_query_iter(world, query);
+    while(ecs_query_next(&it)) {
+        ActorType * type = ecs_field(&it, ActorType, 0);
+        Position * position = ecs_field(&it, Position, 1);
+        Velocity * velocity = ecs_field(&it, Velocity, 2);
+        GroundState * ground = ecs_field(&it, GroundState, 3);
+
+        // the game's billboard query sorts tables in place, so row order follows the camera
+        for(int i = 0; i < it.count; i ++) {
+            sum += ActorHash(&type[i], &position[i], &velocity[i], &ground[i]);
+        }
+    }
+    return sum;
+}
+
+int ActorHashes(ecs_query_t * query, uint32_t * hashes, ecs_entity_t * entities, int capacity) {
+    int count = 0;
+    ecs_iter_t it = ecs_query_iter(world, query);
+    while(ecs_query_next(&it)) {
+        ActorType * type = ecs_field(&it, ActorType, 0);
+        Position * position = ecs_field(&it, Position, 1);
+        Velocity * velocity = ecs_field(&it, Velocity, 2);
+        GroundState * ground = ecs_field(&it, GroundState, 3);
+
+        for(int i = 0; i < it.count; i ++, count ++) {
+            if(count >= capacity)
+                continue;
+            uint64_t h = ActorHash(&type[i], &position[i], &velocity[i], &ground[i]);
+            hashes[count] = (uint32_t)(h ^ (h >> 32));
+            if(entities != NULL)
+                entities[count] = it.entities[i];
+        }
+    }
+    return count;
+}
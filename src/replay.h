@@ -0,0 +1,83 @@
+#ifndef _replay
+#define _replay
+
+#include "headers.h"
+#include "main.h"
+#include "actors.h"
+
+// a recording of the game's simulation: the actors as they were on the first recorded tick, then each
+// tick's input. stress_bench --replay plays it back headless, so the same workload can be profiled again
+// and again. the rng seed is kept too, run the game with --seed to get the same spawn (--seed and --record
+// skip world.snapshot, its saved actors would replace the spawn)
+
+#define REPLAY_MAGIC 0x594c5052        // "RPLY"
+#define REPLAY_VERSION 2
+
+#define REPLAY_PATH "replay.rec"       // in resources/ like the snapshot
+
+typedef struct ReplayHeader {
+    uint32_t magic;
+    uint32_t version;
+    int64_t mapStamp;           // map1.glb's mod time, the colliders come from it
+    uint32_t seed;
+    int32_t prefabCount;
+    int32_t actorGroupCount;
+    int32_t tickCount;          // patched in when the recording stops
+} ReplayHeader;
+
+// after the header, a group per prefab followed by its columns: ActorType, Position, Velocity, GroundState
+typedef struct ReplayActorGroup {
+    int32_t prefab;             // index into the prefabs handed to record and insert
+    int32_t count;
+} ReplayActorGroup;
+
+// then a flags byte per tick, followed by whichever of these changed since the tick before
+#define REPLAY_MOVE 1           // Vector2, the move ActorPhysics got
+#define REPLAY_PICK 2           // Ray, the mouse pick
+#define REPLAY_JUMP 4           // nothing, jump is only set on the tick it's pressed
+#define REPLAY_CHECKSUM 8       // uint64_t, ActorChecksum after the tick
+
+// one tick, unpacked
+typedef struct ReplayTick {
+    Vector2 move;
+    Ray pick;
+    bool jump;
+    bool checked;               // has a checksum
+    uint64_t checksum;
+} ReplayTick;
+
+typedef struct Replay {
+    ReplayHeader header;
+    uint8_t * data;             // the whole file, the actor columns are read out of it
+    ReplayTick * ticks;         // header.tickCount
+    int actorCount;
+} Replay;
+
+// captures the actors now, before the first tick's physics. contacts aren't kept, so start on a tick where
+// the actors haven't moved yet: the frame they're spawned or loaded
+bool StartRecording(const char * path, uint32_t seed, int64_t mapStamp, const ecs_entity_t * prefabs, int prefabCount);
+// after the tick's physics, with what it was given
+void RecordTick(Vector2 move, bool jump, Ray pick, uint64_t checksum);
+void StopRecording(void);
+bool Recording(void);
+
+bool LoadReplay(const char * path, Replay * replay);
+// the recorded actors into the world, before its first tick
+bool InsertReplayActors(const Replay * replay, const ecs_entity_t * prefabs, int prefabCount);
+void UnloadReplay(Replay * replay);
+
+#define CHECKSUM_BASIS 0xcbf29ce484222325ull     // fnv-1a, a word at a time instead of a byte
+#define CHECKSUM_PRIME 0x100000001b3ull
+
+// data has to be whole 32 bit words, floats are hashed by their bits
+uint64_t ChecksumWords(uint64_t h, const void * data, size_t size);
+
+// hash of every actor's type, position, velocity and ground state. actors are added up rather than chained,
+// so two worlds with the same actors agree whatever order their tables and rows are in
+ecs_query_t * ActorChecksumQuery(void);
+uint64_t ActorChecksum(ecs_query_t * query);
+// the same per actor, in the query's order, for finding which one went wrong. entities can be NULL.
+// returns how many actors there are, only capacity of them are written
+int ActorHashes(ecs_query_t * query, uint32_t * hashes, ecs_entity_t * entities, int capacity);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _ring
+#define _ring
+
+#include <assert.h>
+
+// fixed size FIFO with inline storage. N has to be a power of two, the wrap is a mask
+
+#define RING_(T) T##_Ring
+
+#define DECLARE_RING(T, N) typedef struct RING_(T) { \
+    T items[N]; \
+    int head; \
+    int count; \
+} RING_(T); \
+_Static_assert((N) > 0 && ((N) & ((N) - 1)) == 0, "ring size must be a power of two")
+
+#define NEWRING(T) (RING_(T)){ 0 }
+
+#define RING_CAPACITY(R) ((int)(sizeof((R).items) / sizeof((R).items[0])))
+#define RING_EMPTY(R) ((R).count == 0)
+#define RING_FULL(R) ((R).count == RING_CAPACITY(R))
+
+// i counts from the oldest element
+#define RING_INDEX(R, i) ((int)(((unsigned)(R).head + (unsigned)(i)) & (unsigned)(RING_CAPACITY(R) - 1)))
+#define RING_GET(R, i) ((R).items[(assert((i) >= 0 && (i) < (R).count), RING_INDEX(R, i))])
+
+#define RING_PUSH(R, E) do { \
+    assert(!RING_FULL(R)); \
+    (R).items[RING_INDEX(R, (R).count)] = E; \
+    (R).count ++; \
+} while(0)
+
+// drops the oldest element when full
+#define RING_PUSH_OVERWRITE(R, E) do { \
+    if(RING_FULL(R)) { \
+        (R).head = RING_INDEX(R, 1); \
+        (R).count --; \
+    } \
+    RING_PUSH(R, E); \
+} while(0)
+
+#define RING_PEEK(R) RING_GET(R, 0)
+
+#define RING_POP(R, out) do { \
+    assert(!RING_EMPTY(R)); \
+    out = (R).items[(R).head]; \
+    (R).head = RING_INDEX(R, 1); \
+    (R).count --; \
+} while(0)
+
+#define RING_CLEAR(R) ((R).head = (R).count = 0)
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef _simd
+#define _simd
+
+#include <stdint.h>
+#include <math.h>
+
+// 8 float lanes. AVX when the compiler has it turned on, a pair of SSE registers on any other x86-64,
+// plain arrays everywhere else. masks are Float8 with every bit of a lane set (true) or clear (false)
+
+#if defined(__AVX__)
+#define SIMD_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define SIMD_SSE 1
+#include <emmintrin.h>
+#else
+#define SIMD_SCALAR 1
+#endif
+
+#define FLOAT8_LANES 8
+
+#if SIMD_AVX
+
+typedef __m256 Float8;
+
+static inline Float8 Float8Set1(float a) { return _mm256_set1_ps(a); }
+static inline Float8 Float8Make(float a, float b, float c, float d, float e, float f, float g, float h) { return _mm256_setr_ps(a, b, c, d, e, f, g, h); }
+static inline Float8 Float8Load(const float * p) { return _mm256_loadu_ps(p); }
+static inline void Float8Store(float * p, Float8 a) { _mm256_storeu_ps(p, a); }
+static inline Float8 Float8Add(Float8 a, Float8 b) { return _mm256_add_ps(a, b); }
+static inline Float8 Float8Sub(Float8 a, Float8 b) { return _mm256_sub_ps(a, b); }
+static inline Float8 Float8Mul(Float8 a, Float8 b) { return _mm256_mul_ps(a, b); }
+static inline Float8 Float8Div(Float8 a, Float8 b) { return _mm256_div_ps(a, b); }
+static inline Float8 Float8Sqrt(Float8 a) { return _mm256_sqrt_ps(a); }
+static inline Float8 Float8Min(Float8 a, Float8 b) { return _mm256_min_ps(a, b); }
+static inline Float8 Float8Max(Float8 a, Float8 b) { return _mm256_max_ps(a, b); }
+static inline Float8 Float8Less(Float8 a, Float8 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline Float8 Float8Greater(Float8 a, Float8 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline Float8 Float8Equal(Float8 a, Float8 b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+static inline Float8 Float8And(Float8 a, Float8 b) { return _mm256_and_ps(a, b); }
+static inline Float8 Float8AndNot(Float8 mask, Float8 a) { return _mm256_andnot_ps(mask, a); }
+static inline Float8 Float8Select(Float8 mask, Float8 a, Float8 b) { return _mm256_blendv_ps(b, a, mask); }
+
+#elif SIMD_SSE
+
+typedef struct Float8 { __m128 lo, hi; } Float8;
+
+#define FLOAT8_OP(a, b, op) (Float8){ op((a).lo, (b).lo), op((a).hi, (b).hi) }
+
+static inline Float8 Float8Set1(float a) { return (Float8){ _mm_set1_ps(a), _mm_set1_ps(a) }; }
+static inline Float8 Float8Make(float a, float b, float c, float d, float e, float f, float g, float h) { return (Float8){ _mm_setr_ps(a, b, c, d), _mm_setr_ps(e, f, g, h) }; }
+static inline Float8 Float8Load(const float * p) { return (Float8){ _mm_loadu_ps(p), _mm_loadu_ps(p + 4) }; }
+static inline void Float8Store(float * p, Float8 a) { _mm_storeu_ps(p, a.lo); _mm_storeu_ps(p + 4, a.hi); }
+static inline Float8 Float8Add(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_add_ps); }
+static inline Float8 Float8Sub(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_sub_ps); }
+static inline Float8 Float8Mul(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_mul_ps); }
+static inline Float8 Float8Div(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_div_ps); }
+static inline Float8 Float8Sqrt(Float8 a) { return (Float8){ _mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi) }; }
+static inline Float8 Float8Min(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_min_ps); }
+static inline Float8 Float8Max(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_max_ps); }
+static inline Float8 Float8Less(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_cmplt_ps); }
+static inline Float8 Float8Greater(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_cmpgt_ps); }
+static inline Float8 Float8Equal(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_cmpeq_ps); }
+static inline Float8 Float8And(Float8 a, Float8 b) { return FLOAT8_OP(a, b, _mm_and_ps); }
+static inline Float8 Float8AndNot(Float8 mask, Float8 a) { return FLOAT8_OP(mask, a, _mm_andnot_ps); }
+
+// no blendv before SSE4.1
+static inline Float8 Float8Select(Float8 mask, Float8 a, Float8 b) {
+    return (Float8){
+        _mm_or_ps(_mm_and_ps(mask.lo, a.lo), _mm_andnot_ps(mask.lo, b.lo)),
+        _mm_or_ps(_mm_and_ps(mask.hi, a.hi), _mm_andnot_ps(mask.hi, b.hi)),
+    };
+}
+
+#else
+
+typedef struct Float8 { float v[FLOAT8_LANES]; } Float8;
+
+static inline float Float8Bits(uint32_t bits) {
+    union { uint32_t u; float f; } pun = { bits };
+    return pun.f;
+}
+
+static inline uint32_t Float8LaneBits(float f) {
+    union { float f; uint32_t u; } pun = { f };
+    return pun.u;
+}
+
+#define FLOAT8_LANEWISE(expr) do { for(int l = 0; l < FLOAT8_LANES; l ++) r.v[l] = (expr); } while(0)
+#define FLOAT8_MASK(cond) Float8Bits((cond) ? 0xffffffffu : 0u)
+
+static inline Float8 Float8Set1(float a) { Float8 r; FLOAT8_LANEWISE(a); return r; }
+static inline Float8 Float8Make(float a, float b, float c, float d, float e, float f, float g, float h) { return (Float8){ { a, b, c, d, e, f, g, h } }; }
+static inline Float8 Float8Load(const float * p) { Float8 r; FLOAT8_LANEWISE(p[l]); return r; }
+static inline void Float8Store(float * p, Float8 a) { for(int l = 0; l < FLOAT8_LANES; l ++) p[l] = a.v[l]; }
+static inline Float8 Float8Add(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(a.v[l] + b.v[l]); return r; }
+static inline Float8 Float8Sub(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(a.v[l] - b.v[l]); return r; }
+static inline Float8 Float8Mul(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(a.v[l] * b.v[l]); return r; }
+static inline Float8 Float8Div(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(a.v[l] / b.v[l]); return r; }
+static inline Float8 Float8Sqrt(Float8 a) { Float8 r; FLOAT8_LANEWISE(sqrtf(a.v[l])); return r; }
+static inline Float8 Float8Min(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(a.v[l] < b.v[l] ? a.v[l] : b.v[l]); return r; }
+static inline Float8 Float8Max(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(a.v[l] > b.v[l] ? a.v[l] : b.v[l]); return r; }
+static inline Float8 Float8Less(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(FLOAT8_MASK(a.v[l] < b.v[l])); return r; }
+static inline Float8 Float8Greater(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(FLOAT8_MASK(a.v[l] > b.v[l])); return r; }
+static inline Float8 Float8Equal(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(FLOAT8_MASK(a.v[l] == b.v[l])); return r; }
+static inline Float8 Float8And(Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(Float8Bits(Float8LaneBits(a.v[l]) & Float8LaneBits(b.v[l]))); return r; }
+static inline Float8 Float8AndNot(Float8 mask, Float8 a) { Float8 r; FLOAT8_LANEWISE(Float8Bits(~Float8LaneBits(mask.v[l]) & Float8LaneBits(a.v[l]))); return r; }
+static inline Float8 Float8Select(Float8 mask, Float8 a, Float8 b) { Float8 r; FLOAT8_LANEWISE(Float8LaneBits(mask.v[l]) ? a.v[l] : b.v[l]); return r; }
+
+#endif
+
+// lanes from every stride'th float, for pulling one field out of an array of structs
+static inline Float8 Float8Gather(const float * p, int stride) {
+    return Float8Make(p[0], p[stride], p[2*stride], p[3*stride], p[4*stride], p[5*stride], p[6*stride], p[7*stride]);
+}
+
+#endif
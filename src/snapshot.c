@@ -0,0 +1,598 @@
+#include "snapshot.h"
+#include "rlgl.h"
+
+#if defined(_WIN32)
+// no mmap without windows.h, which fights raylib over names (CloseWindow, Rectangle...), so windows reads the file in
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+DECLARE_VECTOR(Model, 8);
+DECLARE_VECTOR(SnapshotModelEntity, 8);
+DECLARE_VECTOR(SnapshotMeshCollider, 8);
+DECLARE_VECTOR(SnapshotActorGroup, 8);
+
+// raw bytes at the end, no padding
+void SnapshotAppend(SnapshotBuffer * buf, const void * data, size_t size) {
+    if(size == 0)
+        return;
+    VECTOR_RESERVE(*buf, buf->size + (int)size);
+    memcpy(VECTOR_DATA(*buf) + buf->size, data, size);
+    buf->size += (int)size;
+}
+
+// pads to SNAPSHOT_ALIGN then appends, returns the offset the data landed at
+uint64_t SnapshotWrite(SnapshotBuffer * buf, const void * data, size_t size) {
+    static const uint8_t zeros[SNAPSHOT_ALIGN] = { 0 };
+    SnapshotAppend(buf, zeros, (SNAPSHOT_ALIGN - buf->size % SNAPSHOT_ALIGN) % SNAPSHOT_ALIGN);
+    uint64_t offset = buf->size;
+    SnapshotAppend(buf, data, size);
+    return offset;
+}
+
+static uint64_t SnapshotWriteOptional(SnapshotBuffer * buf, const void * data, size_t size) {
+    return data ? SnapshotWrite(buf, data, size) : 0;
+}
+
+static SnapshotMesh SnapshotWriteMesh(SnapshotBuffer * buf, Mesh mesh) {
+    size_t vc = mesh.vertexCount;
+    return (SnapshotMesh){
+        .vertexCount = mesh.vertexCount,
+        .triangleCount = mesh.triangleCount,
+        .vertices = SnapshotWriteOptional(buf, mesh.vertices, sizeof(float) * 3 * vc),
+        .texcoords = SnapshotWriteOptional(buf, mesh.texcoords, sizeof(float) * 2 * vc),
+        .texcoords2 = SnapshotWriteOptional(buf, mesh.texcoords2, sizeof(float) * 2 * vc),
+        .normals = SnapshotWriteOptional(buf, mesh.normals, sizeof(float) * 3 * vc),
+        .tangents = SnapshotWriteOptional(buf, mesh.tangents, sizeof(float) * 4 * vc),
+        .colors = SnapshotWriteOptional(buf, mesh.colors, sizeof(unsigned char) * 4 * vc),
+        .indices = SnapshotWriteOptional(buf, mesh.indices, sizeof(unsigned short) * 3 * mesh.triangleCount),
+    };
+}
+
+// reads the texture back off the gpu, the glb it came from isn't kept around. an atlas region is only named
+static SnapshotMaterial SnapshotWriteMaterial(SnapshotBuffer * buf, Material material, const char * atlasRegion) {
+    MaterialMap diffuse = material.maps[MATERIAL_MAP_DIFFUSE];
+    SnapshotMaterial out = { .color = diffuse.color };
+
+    if(atlasRegion != NULL) {
+        snprintf(out.atlasRegion, sizeof(out.atlasRegion), "%s", atlasRegion);
+        return out;
+    }
+    if(diffuse.texture.id == 0 || diffuse.texture.id == rlGetTextureIdDefault())
+        return out;
+
+    Image image = LoadImageFromTexture(diffuse.texture);
+    if(image.data == NULL)
+        return out;
+
+    out.width = image.width;
+    out.height = image.height;
+    out.format = image.format;
+    out.pixels = SnapshotWrite(buf, image.data, GetPixelDataSize(image.width, image.height, image.format));
+    UnloadImage(image);
+    return out;
+}
+
+void SnapshotWriteModel(SnapshotBuffer * buf, Model model, const Atlas * atlas, SnapshotModel * out) {
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+
+    SnapshotMesh * meshes = ArenaAlloc(arena, sizeof(SnapshotMesh) * model.meshCount);
+    for(int i = 0; i < model.meshCount; i ++) {
+        meshes[i] = SnapshotWriteMesh(buf, model.meshes[i]);
+    }
+
+    int materialCount = model.materials ? model.materialCount : 0;
+    SnapshotMaterial * materials = ArenaAlloc(arena, sizeof(SnapshotMaterial) * materialCount);
+    for(int i = 0; i < materialCount; i ++) {
+        const char * region = atlas != NULL ? ModelMaterialAtlasRegion(atlas, model.materials, i) : NULL;
+        materials[i] = SnapshotWriteMaterial(buf, model.materials[i], region);
+    }
+
+    int32_t * meshMaterial = ArenaAlloc(arena, sizeof(int32_t) * model.meshCount);
+    for(int i = 0; i < model.meshCount; i ++) {
+        meshMaterial[i] = model.meshMaterial ? model.meshMaterial[i] : 0;
+    }
+
+    *out = (SnapshotModel){
+        .transform = model.transform,
+        .meshCount = model.meshCount,
+        .materialCount = materialCount,
+        .meshes = SnapshotWrite(buf, meshes, sizeof(SnapshotMesh) * model.meshCount),
+        .materials = materialCount ? SnapshotWrite(buf, materials, sizeof(SnapshotMaterial) * materialCount) : 0,
+        .meshMaterial = SnapshotWrite(buf, meshMaterial, sizeof(int32_t) * model.meshCount),
+    };
+
+    ArenaRewind(arena, mark);
+}
+
+// entities copy Model by value, so two with the same mesh array are the same model
+static int FindSnapshotModel(const VECTOR_(Model) * models, const Mesh * meshes) {
+    for(int i = 0; i < models->size; i ++) {
+        if(VECTOR_DATA(*models)[i].meshes == meshes)
+            return i;
+    }
+    return -1;
+}
+
+// into a temp file renamed over path, the old file may still be mapped with live meshes and hulls in it
+bool WriteSnapshotBuffer(const char * path, const SnapshotBuffer * buf) {
+    const char * temp = TextFormat("%s.tmp", path);
+    FILE * file = fopen(temp, "wb");
+    if(file == NULL)
+        return false;
+
+    bool ok = fwrite(VECTOR_DATA(*buf), 1, buf->size, file) == (size_t)buf->size;
+    ok = fclose(file) == 0 && ok;
+#if defined(_WIN32)
+    // windows won't rename over a file. it reads snapshots into memory, so nothing has this one open
+    if(ok)
+        remove(path);
+#endif
+    ok = ok && rename(temp, path) == 0;
+    if(!ok)
+        remove(temp);
+    return ok;
+}
+
+// one field of every match, back to back. the first call also counts them
+static uint64_t SnapshotWriteColumn(SnapshotBuffer * buf, ecs_query_t * q, int8_t field, size_t size, int32_t * count) {
+    uint64_t offset = SnapshotWrite(buf, NULL, 0);
+    int n = 0;
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while(ecs_query_next(&it)) {
+        SnapshotAppend(buf, ecs_field_w_size(&it, size, field), size * it.count);
+        n += it.count;
+    }
+
+    if(count != NULL)
+        *count = n;
+    return offset;
+}
+
+bool SaveWorldSnapshot(const char * path, int64_t sourceStamp, const Atlas * atlas, const ecs_entity_t * prefabs, int prefabCount) {
+    SnapshotBuffer buf = NEWVECTOR(uint8_t);
+    VECTOR_(Model) models = NEWVECTOR(Model);
+    VECTOR_(SnapshotModelEntity) modelEntities = NEWVECTOR(SnapshotModelEntity);
+    VECTOR_(SnapshotMeshCollider) meshColliders = NEWVECTOR(SnapshotMeshCollider);
+    VECTOR_(SnapshotActorGroup) actorGroups = NEWVECTOR(SnapshotActorGroup);
+    bool ok = true;
+
+    // patched at the end, once the offsets are known
+    SnapshotHeader header = { .magic = SNAPSHOT_MAGIC, .version = SNAPSHOT_VERSION, .sourceStamp = sourceStamp };
+    SnapshotWrite(&buf, &header, sizeof(header));
+
+    // model entities
+    ecs_query_t * q = ecs_query(world, {
+        .terms = { { ecs_id(Model) }, { ecs_id(Matrix), .oper = EcsOptional } }
+    });
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while(ecs_query_next(&it)) {
+        Model * model = ecs_field(&it, Model, 0);
+        Matrix * transform = ecs_field_is_set(&it, 1) ? ecs_field(&it, Matrix, 1) : NULL;
+
+        for(int i = 0; i < it.count; i ++) {
+            int m = FindSnapshotModel(&models, model[i].meshes);
+            if(m < 0) {
+                m = models.size;
+                VECTOR_PUSH(models, model[i]);
+            }
+            SnapshotModelEntity entity = { m, transform != NULL, transform ? transform[i] : MatrixIdentity() };
+            VECTOR_PUSH(modelEntities, entity);
+        }
+    }
+    ecs_query_fini(q);
+
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+    SnapshotModel * snapshotModels = ArenaAlloc(arena, sizeof(SnapshotModel) * models.size);
+    for(int i = 0; i < models.size; i ++) {
+        SnapshotWriteModel(&buf, VECTOR_GET(models, i), atlas, &snapshotModels[i]);
+    }
+    header.modelCount = models.size;
+    header.models = SnapshotWrite(&buf, snapshotModels, sizeof(SnapshotModel) * models.size);
+    ArenaRewind(arena, mark);
+    header.modelEntityCount = modelEntities.size;
+    header.modelEntities = SnapshotWrite(&buf, VECTOR_DATA(modelEntities), sizeof(SnapshotModelEntity) * modelEntities.size);
+
+    // mesh colliders, pointing at their model's mesh by index
+    it = ecs_query_iter(world, q_MeshCollider);
+    while(ecs_query_next(&it)) {
+        MeshCollider * colliders = ecs_field(&it, MeshCollider, 0);
+
+        for(int i = 0; i < it.count; i ++) {
+            SnapshotMeshCollider collider = { -1, -1, colliders[i].box, colliders[i].transform, colliders[i].worldBox, colliders[i].hullCount };
+            if(colliders[i].hull != NULL)
+                collider.hull = SnapshotWrite(&buf, colliders[i].hull, sizeof(Vector3) * colliders[i].hullCount);
+            for(int m = 0; m < models.size && collider.model < 0; m ++) {
+                Model model = VECTOR_GET(models, m);
+                if(colliders[i].mesh >= model.meshes && colliders[i].mesh < model.meshes + model.meshCount) {
+                    collider.model = m;
+                    collider.mesh = (int32_t)(colliders[i].mesh - model.meshes);
+                }
+            }
+
+            if(collider.model < 0) {
+                printf("SNAPSHOT: collider mesh isn't part of any model, not saving\n");
+                ok = false;
+            }
+            VECTOR_PUSH(meshColliders, collider);
+        }
+    }
+    header.meshColliderCount = meshColliders.size;
+    header.meshColliders = SnapshotWrite(&buf, VECTOR_DATA(meshColliders), sizeof(SnapshotMeshCollider) * meshColliders.size);
+
+    header.boxColliders = SnapshotWriteColumn(&buf, q_BoxColliderNotActor, 0, sizeof(BoxCollider), &header.boxColliderCount);
+
+    // actors, a group per prefab
+    for(int p = 0; p < prefabCount; p ++) {
+        q = ecs_query(world, {
+            .terms = {
+                { ecs_id(ActorType) }, { ecs_id(Position) }, { ecs_id(Velocity) }, { ecs_id(GroundState) },
+                { ecs_pair(EcsIsA, prefabs[p]) }
+            }
+        });
+
+        SnapshotActorGroup group = { .prefab = p };
+        group.types = SnapshotWriteColumn(&buf, q, 0, sizeof(ActorType), &group.count);
+        group.positions = SnapshotWriteColumn(&buf, q, 1, sizeof(Position), NULL);
+        group.velocities = SnapshotWriteColumn(&buf, q, 2, sizeof(Velocity), NULL);
+        group.grounds = SnapshotWriteColumn(&buf, q, 3, sizeof(GroundState), NULL);
+        ecs_query_fini(q);
+
+        if(group.count > 0)
+            VECTOR_PUSH(actorGroups, group);
+    }
+    header.actorGroupCount = actorGroups.size;
+    header.actorGroups = SnapshotWrite(&buf, VECTOR_DATA(actorGroups), sizeof(SnapshotActorGroup) * actorGroups.size);
+
+    header.size = buf.size;
+    memcpy(VECTOR_DATA(buf), &header, sizeof(header));
+
+    if(ok)
+        ok = WriteSnapshotBuffer(path, &buf);
+
+    FREEVECTOR(buf);
+    FREEVECTOR(models);
+    FREEVECTOR(modelEntities);
+    FREEVECTOR(meshColliders);
+    FREEVECTOR(actorGroups);
+    return ok;
+}
+
+bool MapFile(const char * path, MappedFile * mapped) {
+#if defined(_WIN32)
+    FILE * file = fopen(path, "rb");
+    if(file == NULL)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void * data = size > 0 ? malloc(size) : NULL;
+    bool ok = data != NULL && fread(data, 1, size, file) == (size_t)size;
+    fclose(file);
+    if(!ok) {
+        free(data);
+        return false;
+    }
+
+    mapped->data = data;
+    mapped->size = size;
+    MemoryCount(MEMORY_MAPPED, mapped->size);
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // private and writable so raylib can scribble on a mesh (tangents...) without touching the file
+    void * data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+        return false;
+
+    mapped->data = data;
+    mapped->size = st.st_size;
+    MemoryCount(MEMORY_MAPPED, mapped->size);
+    return true;
+#endif
+}
+
+void UnmapFile(MappedFile * mapped) {
+#if defined(_WIN32)
+    free(mapped->data);
+#else
+    if(mapped->data != NULL)
+        munmap(mapped->data, mapped->size);
+#endif
+    MemoryCount(MEMORY_MAPPED, -(int64_t)mapped->size);
+    mapped->data = NULL;
+    mapped->size = 0;
+}
+
+bool SnapshotInFile(uint64_t fileSize, uint64_t offset, int64_t count, size_t size) {
+    if(count < 0)
+        return false;
+    if(count == 0)
+        return true;
+    return offset != 0 && offset <= fileSize && (uint64_t)count <= (fileSize - offset) / size;
+}
+
+static bool SnapshotMeshValid(uint64_t fileSize, SnapshotMesh m) {
+    int64_t vc = m.vertexCount;
+    return m.vertexCount >= 0 && m.triangleCount >= 0 &&
+        SnapshotInFile(fileSize, m.vertices, vc, sizeof(float) * 3) &&
+        SnapshotInFile(fileSize, m.texcoords, m.texcoords ? vc : 0, sizeof(float) * 2) &&
+        SnapshotInFile(fileSize, m.texcoords2, m.texcoords2 ? vc : 0, sizeof(float) * 2) &&
+        SnapshotInFile(fileSize, m.normals, m.normals ? vc : 0, sizeof(float) * 3) &&
+        SnapshotInFile(fileSize, m.tangents, m.tangents ? vc : 0, sizeof(float) * 4) &&
+        SnapshotInFile(fileSize, m.colors, m.colors ? vc : 0, sizeof(unsigned char) * 4) &&
+        SnapshotInFile(fileSize, m.indices, m.indices ? (int64_t)m.triangleCount : 0, sizeof(unsigned short) * 3);
+}
+
+bool SnapshotModelValid(const void * base, uint64_t fileSize, SnapshotModel in) {
+    if(!SnapshotInFile(fileSize, in.meshes, in.meshCount, sizeof(SnapshotMesh)) ||
+        !SnapshotInFile(fileSize, in.materials, in.materialCount, sizeof(SnapshotMaterial)) ||
+        !SnapshotInFile(fileSize, in.meshMaterial, in.meshCount, sizeof(int32_t)))
+        return false;
+
+    const SnapshotMesh * meshes = SNAPSHOT_PTR(base, in.meshes);
+    const int32_t * meshMaterial = SNAPSHOT_PTR(base, in.meshMaterial);
+    for(int i = 0; i < in.meshCount; i ++) {
+        if(!SnapshotMeshValid(fileSize, meshes[i]) || meshMaterial[i] < 0 || meshMaterial[i] >= (in.materialCount > 0 ? in.materialCount : 1))
+            return false;
+    }
+
+    const SnapshotMaterial * materials = SNAPSHOT_PTR(base, in.materials);
+    for(int i = 0; i < in.materialCount; i ++) {
+        SnapshotMaterial m = materials[i];
+        if(m.pixels && (m.width <= 0 || m.height <= 0 ||
+            !SnapshotInFile(fileSize, m.pixels, GetPixelDataSize(m.width, m.height, m.format), 1)))
+            return false;
+    }
+    return true;
+}
+
+// everything a load will index into has to be inside the file. mesh indices aren't checked against
+// vertexCount, that would be a pass over every triangle
+static bool SnapshotValid(const WorldSnapshot * snapshot, int64_t sourceStamp, int prefabCount) {
+    const void * base = snapshot->file.data;
+    uint64_t size = snapshot->file.size;
+    const SnapshotHeader * header = base;
+    if(size < sizeof(SnapshotHeader) || header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION ||
+        header->size != size || header->sourceStamp != sourceStamp)
+        return false;
+
+    if(!SnapshotInFile(size, header->models, header->modelCount, sizeof(SnapshotModel)) ||
+        !SnapshotInFile(size, header->modelEntities, header->modelEntityCount, sizeof(SnapshotModelEntity)) ||
+        !SnapshotInFile(size, header->meshColliders, header->meshColliderCount, sizeof(SnapshotMeshCollider)) ||
+        !SnapshotInFile(size, header->boxColliders, header->boxColliderCount, sizeof(BoxCollider)) ||
+        !SnapshotInFile(size, header->actorGroups, header->actorGroupCount, sizeof(SnapshotActorGroup)))
+        return false;
+
+    const SnapshotModel * models = SNAPSHOT_PTR(base, header->models);
+    for(int i = 0; i < header->modelCount; i ++) {
+        if(!SnapshotModelValid(base, size, models[i]))
+            return false;
+    }
+
+    const SnapshotModelEntity * modelEntities = SNAPSHOT_PTR(base, header->modelEntities);
+    for(int i = 0; i < header->modelEntityCount; i ++) {
+        if(modelEntities[i].model < 0 || modelEntities[i].model >= header->modelCount)
+            return false;
+    }
+
+    const SnapshotMeshCollider * colliders = SNAPSHOT_PTR(base, header->meshColliders);
+    for(int i = 0; i < header->meshColliderCount; i ++) {
+        if(colliders[i].model < 0 || colliders[i].model >= header->modelCount ||
+            colliders[i].mesh < 0 || colliders[i].mesh >= models[colliders[i].model].meshCount ||
+            !SnapshotInFile(size, colliders[i].hull, colliders[i].hull ? colliders[i].hullCount : 0, sizeof(Vector3)))
+            return false;
+    }
+
+    const SnapshotActorGroup * groups = SNAPSHOT_PTR(base, header->actorGroups);
+    for(int i = 0; i < header->actorGroupCount; i ++) {
+        SnapshotActorGroup g = groups[i];
+        if(g.prefab < 0 || g.prefab >= prefabCount ||
+            !SnapshotInFile(size, g.types, g.count, sizeof(ActorType)) ||
+            !SnapshotInFile(size, g.positions, g.count, sizeof(Position)) ||
+            !SnapshotInFile(size, g.velocities, g.count, sizeof(Velocity)) ||
+            !SnapshotInFile(size, g.grounds, g.count, sizeof(GroundState)))
+            return false;
+    }
+    return true;
+}
+
+static Mesh SnapshotPrepareMesh(void * base, SnapshotMesh in) {
+    Mesh mesh = { 0 };
+    mesh.vertexCount = in.vertexCount;
+    mesh.triangleCount = in.triangleCount;
+    mesh.vertices = SNAPSHOT_PTR(base, in.vertices);
+    mesh.texcoords = SNAPSHOT_PTR(base, in.texcoords);
+    mesh.texcoords2 = SNAPSHOT_PTR(base, in.texcoords2);
+    mesh.normals = SNAPSHOT_PTR(base, in.normals);
+    mesh.tangents = SNAPSHOT_PTR(base, in.tangents);
+    mesh.colors = SNAPSHOT_PTR(base, in.colors);
+    mesh.indices = SNAPSHOT_PTR(base, in.indices);
+    return mesh;
+}
+
+// no gl calls in here, so it's fine off the main thread. materials get raylib's default texture until uploaded
+Model SnapshotPrepareModel(void * base, SnapshotModel in) {
+    Model model = { 0 };
+    model.transform = in.transform;
+    model.meshCount = in.meshCount;
+    model.materialCount = in.materialCount;
+
+    // the arrays come from raylib's allocator, UnloadModel frees them
+    const SnapshotMesh * meshes = SNAPSHOT_PTR(base, in.meshes);
+    const int32_t * meshMaterial = SNAPSHOT_PTR(base, in.meshMaterial);
+    model.meshes = RL_CALLOC(in.meshCount, sizeof(Mesh));
+    model.meshMaterial = RL_CALLOC(in.meshCount, sizeof(int));
+    for(int i = 0; i < in.meshCount; i ++) {
+        model.meshes[i] = SnapshotPrepareMesh(base, meshes[i]);
+        model.meshMaterial[i] = meshMaterial[i];
+    }
+
+    const SnapshotMaterial * materials = SNAPSHOT_PTR(base, in.materials);
+    model.materials = in.materialCount ? RL_CALLOC(in.materialCount, sizeof(Material)) : NULL;
+    for(int i = 0; i < in.materialCount; i ++) {
+        model.materials[i] = LoadMaterialDefault();
+        model.materials[i].maps[MATERIAL_MAP_DIFFUSE].color = materials[i].color;
+    }
+
+    return model;
+}
+
+int SnapshotModelParts(SnapshotModel in) {
+    return in.meshCount + in.materialCount;
+}
+
+// the gpu half, a mesh or a texture per part so a load can be spread over frames
+void SnapshotUploadModelPart(void * base, SnapshotModel in, Model * model, int part) {
+    if(part < in.meshCount) {
+        UploadMesh(&model->meshes[part], false);
+        return;
+    }
+
+    int i = part - in.meshCount;
+    const SnapshotMaterial * materials = SNAPSHOT_PTR(base, in.materials);
+    if(materials[i].pixels) {
+        Image image = { SNAPSHOT_PTR(base, materials[i].pixels), materials[i].width, materials[i].height, 1, materials[i].format };
+        model->materials[i].maps[MATERIAL_MAP_DIFFUSE].texture = LoadTextureFromImage(image);
+        MemoryCount(MEMORY_TEXTURES, TEXTURE_BYTES(model->materials[i].maps[MATERIAL_MAP_DIFFUSE].texture));
+    }
+}
+
+Model SnapshotLoadModel(void * base, SnapshotModel in) {
+    Model model = SnapshotPrepareModel(base, in);
+    for(int part = 0; part < SnapshotModelParts(in); part ++) {
+        SnapshotUploadModelPart(base, in, &model, part);
+    }
+    return model;
+}
+
+bool LoadWorldSnapshot(const char * path, int64_t sourceStamp, WorldSnapshot * snapshot, const ecs_entity_t * prefabs, int prefabCount) {
+    *snapshot = (WorldSnapshot){ 0 };
+    if(!MapFile(path, &snapshot->file))
+        return false;
+
+    if(!SnapshotValid(snapshot, sourceStamp, prefabCount)) {
+        printf("SNAPSHOT: %s is stale or from another version, ignoring it\n", path);
+        UnmapFile(&snapshot->file);
+        return false;
+    }
+
+    void * base = snapshot->file.data;
+    const SnapshotHeader * header = base;
+
+    // models
+    const SnapshotModel * models = SNAPSHOT_PTR(base, header->models);
+    snapshot->modelCount = header->modelCount;
+    snapshot->models = RL_CALLOC(header->modelCount ? header->modelCount : 1, sizeof(Model));
+    for(int i = 0; i < header->modelCount; i ++) {
+        snapshot->models[i] = SnapshotLoadModel(base, models[i]);
+    }
+
+    // there are only a handful of these
+    const SnapshotModelEntity * modelEntities = SNAPSHOT_PTR(base, header->modelEntities);
+    for(int i = 0; i < header->modelEntityCount; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set_ptr(world, e, Model, &snapshot->models[modelEntities[i].model]);
+        if(modelEntities[i].hasMatrix)
+            ecs_set_ptr(world, e, Matrix, &modelEntities[i].transform);
+    }
+
+    // colliders, baked bounds and all
+    Arena * arena = FrameArena();
+    size_t mark = ArenaMark(arena);
+    const SnapshotMeshCollider * meshColliders = SNAPSHOT_PTR(base, header->meshColliders);
+    MeshCollider * colliders = FRAME_ALLOC(MeshCollider, header->meshColliderCount);
+    for(int i = 0; i < header->meshColliderCount; i ++) {
+        SnapshotMeshCollider c = meshColliders[i];
+        colliders[i] = (MeshCollider){ &snapshot->models[c.model].meshes[c.mesh], c.box, c.transform, c.worldBox,
+            SNAPSHOT_PTR(base, c.hull), c.hull ? c.hullCount : 0 };
+    }
+    if(header->meshColliderCount > 0) {
+        ecs_bulk_init(world, &(ecs_bulk_desc_t){
+            .count = header->meshColliderCount,
+            .ids = { ecs_id(MeshCollider) },
+            .data = (void *[]){ colliders },
+        });
+    }
+    ArenaRewind(arena, mark);
+
+    if(header->boxColliderCount > 0) {
+        ecs_bulk_init(world, &(ecs_bulk_desc_t){
+            .count = header->boxColliderCount,
+            .ids = { ecs_id(BoxCollider) },
+            .data = (void *[]){ SNAPSHOT_PTR(base, header->boxColliders) },
+        });
+    }
+
+    // actors straight from the file's columns
+    const SnapshotActorGroup * groups = SNAPSHOT_PTR(base, header->actorGroups);
+    for(int i = 0; i < header->actorGroupCount; i ++) {
+        SnapshotActorGroup g = groups[i];
+        InsertActors(prefabs[g.prefab], SNAPSHOT_PTR(base, g.types), SNAPSHOT_PTR(base, g.positions),
+            SNAPSHOT_PTR(base, g.velocities), SNAPSHOT_PTR(base, g.grounds), g.count, NULL);
+    }
+
+    return true;
+}
+
+void BindSnapshotAtlas(WorldSnapshot * snapshot, Atlas * atlas) {
+    void * base = snapshot->file.data;
+    const SnapshotHeader * header = base;
+    const SnapshotModel * models = SNAPSHOT_PTR(base, header->models);
+    for(int i = 0; i < snapshot->modelCount; i ++) {
+        const SnapshotMaterial * materials = SNAPSHOT_PTR(base, models[i].materials);
+        for(int m = 0; m < models[i].materialCount; m ++) {
+            if(materials[m].atlasRegion[0] != '\0' && memchr(materials[m].atlasRegion, '\0', ATLAS_NAME_LENGTH) != NULL)
+                BindModelMaterialAtlas(&snapshot->models[i], m, atlas, materials[m].atlasRegion);
+        }
+    }
+}
+
+// cpu buffers live in the mapping, let UnloadModel free only what it allocated
+void UnloadSnapshotModel(Model model) {
+    for(int m = 0; m < model.meshCount; m ++) {
+        Mesh * mesh = &model.meshes[m];
+        mesh->vertices = NULL;
+        mesh->texcoords = NULL;
+        mesh->texcoords2 = NULL;
+        mesh->normals = NULL;
+        mesh->tangents = NULL;
+        mesh->colors = NULL;
+        mesh->indices = NULL;
+    }
+    for(int i = 0; i < model.materialCount; i ++) {
+        Texture2D texture = model.materials[i].maps[MATERIAL_MAP_DIFFUSE].texture;
+        if(texture.id != 0 && texture.id != rlGetTextureIdDefault())
+            MemoryCount(MEMORY_TEXTURES, -TEXTURE_BYTES(texture));
+    }
+    UnloadModel(model);
+}
+
+void UnloadWorldSnapshot(WorldSnapshot * snapshot) {
+    for(int i = 0; i < snapshot->modelCount; i ++) {
+        UnloadSnapshotModel(snapshot->models[i]);
+    }
+    RL_FREE(snapshot->models);
+    snapshot->models = NULL;
+    snapshot->modelCount = 0;
+
+    UnmapFile(&snapshot->file);
+}
@@ -0,0 +1,144 @@
+#ifndef _snapshot
+#define _snapshot
+
+#include "headers.h"
+#include "main.h"
+#include "collision.h"
+#include "actors.h"
+#include "atlas.h"
+
+// the loaded world written out as one flat file: mesh buffers, baked colliders and actor columns.
+// loading maps the file and points meshes straight into it, the only parsing is a header check
+
+#define SNAPSHOT_MAGIC 0x544e5357      // "WSNT"
+#define SNAPSHOT_VERSION 3
+#define SNAPSHOT_ALIGN 16
+
+#define WORLD_SNAPSHOT_PATH "world.snapshot"     // next to the glbs in resources/
+
+// everything is an offset from the start of the file, 0 for none
+typedef struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;
+    int64_t sourceStamp;        // newest mod time of the files the world was built from
+
+    int32_t modelCount;
+    int32_t modelEntityCount;
+    int32_t meshColliderCount;
+    int32_t boxColliderCount;
+    int32_t actorGroupCount;
+    int32_t pad;
+
+    uint64_t models;            // SnapshotModel[modelCount]
+    uint64_t modelEntities;     // SnapshotModelEntity[modelEntityCount]
+    uint64_t meshColliders;     // SnapshotMeshCollider[meshColliderCount]
+    uint64_t boxColliders;      // BoxCollider[boxColliderCount]
+    uint64_t actorGroups;       // SnapshotActorGroup[actorGroupCount]
+} SnapshotHeader;
+
+// cpu side of a Mesh, no animation data
+typedef struct SnapshotMesh {
+    int32_t vertexCount;
+    int32_t triangleCount;
+    uint64_t vertices;
+    uint64_t texcoords;
+    uint64_t texcoords2;
+    uint64_t normals;
+    uint64_t tangents;
+    uint64_t colors;
+    uint64_t indices;
+} SnapshotMesh;
+
+// only the diffuse map survives, which is all DrawModel uses with the default shader
+typedef struct SnapshotMaterial {
+    Color color;
+    int32_t width;
+    int32_t height;
+    int32_t format;
+    uint64_t pixels;            // 0 for the default texture, or when it's the atlas'
+    char atlasRegion[ATLAS_NAME_LENGTH];    // bound to this region, its uvs are stored squeezed into it already
+} SnapshotMaterial;
+
+typedef struct SnapshotModel {
+    Matrix transform;
+    int32_t meshCount;
+    int32_t materialCount;
+    uint64_t meshes;            // SnapshotMesh[meshCount]
+    uint64_t materials;         // SnapshotMaterial[materialCount]
+    uint64_t meshMaterial;      // int32_t[meshCount]
+} SnapshotModel;
+
+typedef struct SnapshotModelEntity {
+    int32_t model;
+    int32_t hasMatrix;
+    Matrix transform;
+} SnapshotModelEntity;
+
+// a MeshCollider with its mesh pointer swapped for an index
+typedef struct SnapshotMeshCollider {
+    int32_t model;
+    int32_t mesh;
+    BoundingBox box;
+    Matrix transform;
+    BoundingBox worldBox;
+    int32_t hullCount;
+    int32_t pad;
+    uint64_t hull;              // Vector3[hullCount]
+} SnapshotMeshCollider;
+
+// actors of one prefab, column by column so they go straight into InsertActors
+typedef struct SnapshotActorGroup {
+    int32_t prefab;             // index into the prefabs handed to save and load
+    int32_t count;
+    uint64_t types;
+    uint64_t positions;
+    uint64_t velocities;
+    uint64_t grounds;
+} SnapshotActorGroup;
+
+// a whole file in memory, mapped where the platform allows it
+typedef struct MappedFile {
+    void * data;
+    size_t size;
+} MappedFile;
+
+// what a load leaves behind to be freed
+typedef struct WorldSnapshot {
+    MappedFile file;
+    Model * models;
+    int modelCount;
+} WorldSnapshot;
+
+// materials bound to atlas are saved as their region instead of pixels, it can be NULL
+bool SaveWorldSnapshot(const char * path, int64_t sourceStamp, const Atlas * atlas, const ecs_entity_t * prefabs, int prefabCount);
+bool LoadWorldSnapshot(const char * path, int64_t sourceStamp, WorldSnapshot * snapshot, const ecs_entity_t * prefabs, int prefabCount);
+// binds the materials that were saved as a region, once the atlas has its texture
+void BindSnapshotAtlas(WorldSnapshot * snapshot, Atlas * atlas);
+void UnloadWorldSnapshot(WorldSnapshot * snapshot);
+
+// the pieces, shared with the asset cache
+DECLARE_VECTOR(uint8_t, 16);
+typedef VECTOR_(uint8_t) SnapshotBuffer;
+
+#define SNAPSHOT_PTR(base, offset) ((offset) ? (void *)((char *)(base) + (offset)) : NULL)
+
+void SnapshotAppend(SnapshotBuffer * buf, const void * data, size_t size);
+uint64_t SnapshotWrite(SnapshotBuffer * buf, const void * data, size_t size);
+bool WriteSnapshotBuffer(const char * path, const SnapshotBuffer * buf);
+// count elements of size at offset fit in a file of fileSize. offset 0 is fine when there are none
+bool SnapshotInFile(uint64_t fileSize, uint64_t offset, int64_t count, size_t size);
+// the model's arrays, mesh buffers and pixels are all inside the file
+bool SnapshotModelValid(const void * base, uint64_t fileSize, SnapshotModel in);
+
+void SnapshotWriteModel(SnapshotBuffer * buf, Model model, const Atlas * atlas, SnapshotModel * out);
+Model SnapshotLoadModel(void * base, SnapshotModel in);
+Model SnapshotPrepareModel(void * base, SnapshotModel in);
+int SnapshotModelParts(SnapshotModel in);
+void SnapshotUploadModelPart(void * base, SnapshotModel in, Model * model, int part);
+void UnloadSnapshotModel(Model model);
+
+bool MapFile(const char * path, MappedFile * mapped);
+void UnmapFile(MappedFile * mapped);
+
+#endif
@@ -14,6 +14,6 @@ typedef struct ActorCompass {
     float avoid[COMPASS_RES];   // actor's avoid compass
 } ActorCompass;
 
-void SteerActor(ActorCompass * compass, Actor actor, Position position);
+void SteerActor(ActorCompass * compass, ActorType type, Position position);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef _vector
+#define _vector
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "memstats.h"
+
+// growable array with N elements of inline storage before it touches the heap.
+// the inline buffer is used while arr is NULL, so vectors can be copied around safely until they spill
+
+#define VECTOR_(T) T##_Vector
+
+#define DECLARE_VECTOR(T, N) typedef struct VECTOR_(T) { \
+    union { T * arr; void * data; }; \
+    int size; \
+    int capacity; \
+    T small[N]; \
+} VECTOR_(T)
+
+#define NEWVECTOR(T) (VECTOR_(T)){ 0 }
+
+#define VECTOR_SMALL_CAPACITY(V) ((int)(sizeof((V).small) / sizeof((V).small[0])))
+#define VECTOR_CAPACITY(V) ((V).arr ? (V).capacity : VECTOR_SMALL_CAPACITY(V))
+#define VECTOR_DATA(V) ((V).arr ? (V).arr : (V).small)
+
+// the helpers take and return values, never &V, so a local vector's fields can stay in registers
+#define VECTOR_RESIZE_STORAGE(V, newCapacity) do { \
+    int capacity_ = (newCapacity); \
+    (V).data = VectorRealloc((V).data, (V).small, VECTOR_SMALL_CAPACITY(V), (V).size, capacity_, sizeof((V).small[0])); \
+    (V).capacity = (V).data ? capacity_ : 0; \
+} while(0)
+
+#define VECTOR_RESERVE(V, n) do { \
+    if((n) > VECTOR_CAPACITY(V)) \
+        VECTOR_RESIZE_STORAGE(V, VectorGrowCapacity(VECTOR_CAPACITY(V), (n))); \
+} while(0)
+
+#define VECTOR_PUSH(V, E) do { \
+    if((V).size >= VECTOR_CAPACITY(V)) \
+        VECTOR_RESIZE_STORAGE(V, VectorGrowCapacity(VECTOR_CAPACITY(V), (V).size + 1)); \
+    VECTOR_DATA(V)[(V).size ++] = E; \
+} while(0)
+
+#define VECTOR_POP(V) (assert((V).size > 0), VECTOR_DATA(V)[-- (V).size])
+
+#define VECTOR_GET(V, i) (VECTOR_DATA(V)[(assert((i) >= 0 && (i) < (V).size), (i))])
+#define VECTOR_SET(V, i, val) (VECTOR_GET(V, i) = (val))
+
+// moves the last element into i, order isn't kept
+#define VECTOR_REMOVE_SWAP(V, i) do { \
+    assert((i) >= 0 && (i) < (V).size); \
+    VECTOR_DATA(V)[i] = VECTOR_DATA(V)[-- (V).size]; \
+} while(0)
+
+#define VECTOR_CLEAR(V) ((V).size = 0)
+
+// give back unused heap, moving back inline if it fits
+#define VECTOR_SHRINK(V) do { \
+    if((V).arr && (V).size < (V).capacity) \
+        VECTOR_RESIZE_STORAGE(V, (V).size); \
+} while(0)
+
+#define FREEVECTOR(V) do { \
+    MemoryFree((V).arr); \
+    (V).arr = NULL; \
+    (V).size = 0; \
+    (V).capacity = 0; \
+} while(0)
+
+static inline int VectorGrowCapacity(int capacity, int needed) {
+    while(capacity < needed)
+        capacity *= 2;
+    return capacity;
+}
+
+// moves between the inline buffer (NULL) and the heap as the capacity crosses smallCapacity
+static inline void * VectorRealloc(void * data, void * small, int smallCapacity, int size, int capacity, size_t esize) {
+    if(capacity <= smallCapacity) {
+        if(data) {
+            memcpy(small, data, esize * size);
+            MemoryFree(data);
+        }
+        return NULL;
+    }
+
+    if(data) {
+        data = MemoryRealloc(MEMORY_LISTS, data, esize * capacity);
+    }
+    else {
+        data = MemoryAlloc(MEMORY_LISTS, esize * capacity);
+        memcpy(data, small, esize * size);
+    }
+    assert(data != NULL);
+    return data;
+}
+
+#endif
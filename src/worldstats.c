@@ -0,0 +1,266 @@
+#include "worldstats.h"
+
+typedef struct SystemRow {
+    ecs_entity_t system;
+    const char * name;
+    ecs_system_stats_t stats;
+    int samples;                // the first is against whatever was last seen, so it's not shown
+    bool active;                // in this frame's pipeline
+} SystemRow;
+
+typedef struct QueryRow {
+    const char * name;
+    const ecs_query_t * query;
+    ecs_query_stats_t stats;
+} QueryRow;
+
+static ecs_world_stats_t worldStats;
+static ecs_pipeline_stats_t pipelineStats;
+static SystemRow systems[WORLD_STATS_SYSTEMS];
+static int systemCount;
+static QueryRow queries[WORLD_STATS_QUERIES];
+static int queryCount;
+static bool shown;
+static int samples;
+static bool measuring;          // timing was already on, the stats module keeps it on for the explorer
+
+// flecs has no counter for entities changing tables, but it traces every commit that does
+static int64_t tableMoves;
+static int64_t lastTableMoves;
+static float moveHistory[ECS_STAT_WINDOW];     // same slots as worldStats.t
+static ecs_os_api_perf_trace_t nextPush;
+static ecs_os_api_perf_trace_t nextPop;
+
+static void TracePush(const char * file, size_t line, const char * name) {
+    if(name != NULL && strcmp(name, "flecs.commit") == 0)
+        tableMoves ++;
+    if(nextPush != NULL)
+        nextPush(file, line, name);
+}
+
+static void TracePop(const char * file, size_t line, const char * name) {
+    if(nextPop != NULL)
+        nextPop(file, line, name);
+}
+
+void StartWorldStats(void) {
+    // whoever had the hooks still gets every call
+    nextPush = ecs_os_api.perf_trace_push_;
+    nextPop = ecs_os_api.perf_trace_pop_;
+    ecs_os_api.perf_trace_push_ = TracePush;
+    ecs_os_api.perf_trace_pop_ = TracePop;
+}
+
+void StopWorldStats(void) {
+    if(ecs_os_api.perf_trace_push_ == TracePush)
+        ecs_os_api.perf_trace_push_ = nextPush;
+    if(ecs_os_api.perf_trace_pop_ == TracePop)
+        ecs_os_api.perf_trace_pop_ = nextPop;
+
+    ecs_pipeline_stats_fini(&pipelineStats);
+    pipelineStats = (ecs_pipeline_stats_t){ 0 };
+    systemCount = 0;
+    queryCount = 0;
+    ShowWorldStats(false);
+}
+
+void AddWorldStatsQuery(const char * name, const ecs_query_t * query) {
+    if(queryCount < WORLD_STATS_QUERIES)
+        queries[queryCount ++] = (QueryRow){ .name = name, .query = query };
+}
+
+void ShowWorldStats(bool show) {
+    if(show == shown)
+        return;
+
+    if(show) {
+        measuring = world != NULL && (ecs_world_get_flags(world) & EcsWorldMeasureSystemTime) != 0;
+        samples = 0;
+        lastTableMoves = tableMoves;
+        for(int i = 0; i < systemCount; i ++) {
+            systems[i].samples = 0;
+        }
+    }
+    shown = show;
+    if(world != NULL && !measuring) {
+        ecs_measure_frame_time(world, show);
+        ecs_measure_system_time(world, show);
+    }
+}
+
+bool WorldStatsShown(void) {
+    return shown;
+}
+
+static SystemRow * FindSystemRow(ecs_entity_t system) {
+    for(int i = 0; i < systemCount; i ++) {
+        if(systems[i].system == system)
+            return &systems[i];
+    }
+    if(systemCount == WORLD_STATS_SYSTEMS)
+        return NULL;
+
+    SystemRow * row = &systems[systemCount ++];
+    *row = (SystemRow){ .system = system, .name = ecs_get_name(world, system) };
+    if(row->name == NULL)
+        row->name = "(unnamed)";
+    return row;
+}
+
+void UpdateWorldStats(void) {
+    if(!shown)
+        return;
+
+    ecs_world_stats_get(world, &worldStats);
+    moveHistory[worldStats.t] = (float)(tableMoves - lastTableMoves);
+    lastTableMoves = tableMoves;
+    samples ++;
+
+    for(int i = 0; i < systemCount; i ++) {
+        systems[i].active = false;
+    }
+
+    // merge points are 0 in the list
+    if(ecs_pipeline_stats_get(world, ecs_get_pipeline(world), &pipelineStats)) {
+        ecs_entity_t * ids = ecs_vec_first_t(&pipelineStats.systems, ecs_entity_t);
+        for(int i = 0; i < ecs_vec_count(&pipelineStats.systems); i ++) {
+            SystemRow * row = ids[i] != 0 ? FindSystemRow(ids[i]) : NULL;
+            if(row == NULL)
+                continue;
+            ecs_system_stats_get(world, row->system, &row->stats);
+            row->samples ++;
+            row->active = true;
+        }
+    }
+
+    for(int i = 0; i < queryCount; i ++) {
+        ecs_query_stats_get(world, queries[i].query, &queries[i].stats);
+    }
+}
+
+static float Gauge(const ecs_metric_t * m, int t) {
+    return m->gauge.avg[t];
+}
+
+// counters are kept as totals, this is the last frame's change
+static float Rate(const ecs_metric_t * m, int t) {
+    return m->counter.rate.avg[t];
+}
+
+static float SystemMs(const SystemRow * row) {
+    return row->samples > 1 ? Rate(&row->stats.time_spent, row->stats.query.t) * 1000.0f : 0.0f;
+}
+
+static int CompareSystemTime(const void * a, const void * b) {
+    float ta = SystemMs(*(const SystemRow * const *)a);
+    float tb = SystemMs(*(const SystemRow * const *)b);
+    return (tb > ta) - (tb < ta);
+}
+
+// values is one of the stats rings, drawn oldest to newest ending at slot t
+static void DrawGraph(int x, int y, int width, int height, const char * label, const float * values, float scale, Color color) {
+    int count = samples - 1;
+    if(count > ECS_STAT_WINDOW)
+        count = ECS_STAT_WINDOW;
+
+    float top = 0;
+    for(int i = 0; i < count; i ++) {
+        float v = values[(worldStats.t - i + ECS_STAT_WINDOW) % ECS_STAT_WINDOW] * scale;
+        if(v > top)
+            top = v;
+    }
+
+    DrawRectangle(x, y, width, height, Fade(DARKGRAY, 0.5f));
+    float barWidth = (float)width / ECS_STAT_WINDOW;
+    for(int i = 0; i < count && top > 0; i ++) {
+        float v = values[(worldStats.t - i + ECS_STAT_WINDOW) % ECS_STAT_WINDOW] * scale;
+        int barHeight = (int)(v / top * height);
+        DrawRectangle(x + width - (int)((i + 1) * barWidth), y + height - barHeight, (int)barWidth + 1, barHeight, color);
+    }
+    DrawText(TextFormat("%s  max %.3g", label, top), x + 2, y + 2, 10, WHITE);
+}
+
+// the default font isn't monospaced, so columns go at fixed offsets
+static void DrawStatsRow(int x, int y, const char * name, const char * ms, const char * tables, const char * entities, Color color) {
+    DrawText(name, x, y, 10, color);
+    DrawText(ms, x + 240, y, 10, color);
+    DrawText(tables, x + 310, y, 10, color);
+    DrawText(entities, x + 380, y, 10, color);
+}
+
+void DrawWorldStats(int x, int y) {
+    const int width = 460;
+    const int line = 12;
+    const int fontSize = 10;
+    const int graphHeight = 36;
+
+    SystemRow * order[WORLD_STATS_SYSTEMS];
+    int rows = 0;
+    for(int i = 0; i < systemCount; i ++) {
+        if(systems[i].active)
+            order[rows ++] = &systems[i];
+    }
+    qsort(order, rows, sizeof(order[0]), CompareSystemTime);
+    if(rows > WORLD_STATS_ROWS)
+        rows = WORLD_STATS_ROWS;
+
+    int height = line * (7 + rows + queryCount) + (graphHeight + 4) * 2 + 8;
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.7f));
+    if(samples < 2) {
+        DrawText("flecs stats, gathering...", x + 4, y + 4, fontSize, WHITE);
+        return;
+    }
+
+    const ecs_world_stats_t * s = &worldStats;
+    int t = s->t;
+    int ty = y + 4;
+    DrawText(TextFormat("flecs   frame %.2f ms   systems %.2f ms   merges %.2f ms   F1 hide",
+        Rate(&s->performance.frame_time, t) * 1000.0f, Rate(&s->performance.system_time, t) * 1000.0f,
+        Rate(&s->performance.merge_time, t) * 1000.0f), x + 4, ty, fontSize, WHITE);
+    ty += line;
+    DrawText(TextFormat("entities %.0f (%.0f recyclable)   tables %.0f, +%.0f -%.0f   components %.0f   pairs %.0f",
+        Gauge(&s->entities.count, t), Gauge(&s->entities.not_alive_count, t), Gauge(&s->tables.count, t),
+        Rate(&s->tables.create_count, t), Rate(&s->tables.delete_count, t),
+        Gauge(&s->components.component_count, t), Gauge(&s->components.pair_count, t)), x + 4, ty, fontSize, WHITE);
+    ty += line;
+    DrawText(TextFormat("queries %.0f   observers %.0f   systems %.0f (%d active)   ran %.0f   rematches %.0f   pipeline builds %.0f",
+        Gauge(&s->queries.query_count, t), Gauge(&s->queries.observer_count, t), Gauge(&s->queries.system_count, t),
+        pipelineStats.active_system_count, Rate(&s->frame.systems_ran, t), Rate(&s->frame.rematch_count, t),
+        Rate(&s->frame.pipeline_build_count, t)), x + 4, ty, fontSize, WHITE);
+    ty += line;
+#ifdef FLECS_PERF_TRACE
+    const char * moves = TextFormat("%.0f", moveHistory[t]);
+#else
+    const char * moves = "n/a (needs FLECS_PERF_TRACE)";
+#endif
+    DrawText(TextFormat("table moves %s   commands add %.0f remove %.0f set %.0f delete %.0f   observers ran %.0f",
+        moves, Rate(&s->commands.add_count, t), Rate(&s->commands.remove_count, t), Rate(&s->commands.set_count, t),
+        Rate(&s->commands.delete_count, t), Rate(&s->frame.observers_ran, t)), x + 4, ty, fontSize, WHITE);
+    ty += line + 4;
+
+    int graphWidth = (width - 16) / 2;
+    DrawGraph(x + 4, ty, graphWidth, graphHeight, "frame ms", s->performance.frame_time.counter.rate.avg, 1000.0f, ORANGE);
+    DrawGraph(x + 12 + graphWidth, ty, graphWidth, graphHeight, "system ms", s->performance.system_time.counter.rate.avg, 1000.0f, GOLD);
+    ty += graphHeight + 4;
+    DrawGraph(x + 4, ty, graphWidth, graphHeight, "table moves", moveHistory, 1.0f, SKYBLUE);
+    DrawGraph(x + 12 + graphWidth, ty, graphWidth, graphHeight, "tables created", s->tables.create_count.counter.rate.avg, 1.0f, PINK);
+    ty += graphHeight + 4;
+
+    DrawStatsRow(x + 4, ty, "system", "ms", "tables", "entities", LIGHTGRAY);
+    ty += line;
+    for(int i = 0; i < rows; i ++) {
+        const ecs_query_stats_t * q = &order[i]->stats.query;
+        DrawStatsRow(x + 4, ty, order[i]->name, TextFormat("%.3f", SystemMs(order[i])),
+            TextFormat("%.0f", Gauge(&q->matched_table_count, q->t)), TextFormat("%.0f", Gauge(&q->matched_entity_count, q->t)), WHITE);
+        ty += line;
+    }
+
+    DrawStatsRow(x + 4, ty, "query", "", "tables", "entities", LIGHTGRAY);
+    ty += line;
+    for(int i = 0; i < queryCount; i ++) {
+        const ecs_query_stats_t * q = &queries[i].stats;
+        DrawStatsRow(x + 4, ty, queries[i].name, "",
+            TextFormat("%.0f", Gauge(&q->matched_table_count, q->t)), TextFormat("%.0f", Gauge(&q->matched_entity_count, q->t)), WHITE);
+        ty += line;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef _worldstats
+#define _worldstats
+
+#include "headers.h"
+#include "main.h"
+
+// flecs' own statistics as an overlay: entities, tables, queries, commands, table moves and what each
+// system costs, with the last ECS_STAT_WINDOW frames graphed. nothing is gathered while it's hidden,
+// except counting the table moves
+
+#define WORLD_STATS_SYSTEMS 32          // pipeline systems tracked, the rest are left out
+#define WORLD_STATS_QUERIES 8           // extra queries from AddWorldStatsQuery
+#define WORLD_STATS_ROWS 10             // most expensive systems listed
+
+// after ecs_init, and after StartProfiler when both are used, the table move count rides on the perf trace hooks
+void StartWorldStats(void);
+void StopWorldStats(void);
+
+// a query that isn't a system's, shown with its matched tables and entities. name isn't copied
+void AddWorldStatsQuery(const char * name, const ecs_query_t * query);
+
+// turns system timing on with it, which costs a little in every system run
+void ShowWorldStats(bool show);
+bool WorldStatsShown(void);
+
+// once a frame after ecs_progress, samples the frame that just ran
+void UpdateWorldStats(void);
+void DrawWorldStats(int x, int y);
+
+#endif